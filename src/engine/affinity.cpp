@@ -0,0 +1,200 @@
+#include "affinity.hpp"
+#include <sched.h>
+#include <algorithm>
+#include <charconv>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <string>
+#include <utils.hpp>
+
+namespace {
+
+[[nodiscard]] auto read_file(const std::filesystem::path &path) -> std::string {
+    std::ifstream file(path);
+    auto str = std::string();
+    std::getline(file, str);
+    return str;
+}
+
+[[nodiscard]] auto parse_int(const std::string_view str, int &value) noexcept -> bool {
+    const auto [ptr, ec] = std::from_chars(str.data(), str.data() + str.size(), value);
+    return ec == std::errc() && ptr == str.data() + str.size();
+}
+
+}  // namespace
+
+[[nodiscard]] auto parse_cpu_list(const std::string_view str) -> CpuSet {
+    auto cpus = CpuSet();
+
+    for (auto part : utils::split(str, ",\n")) {
+        const auto idx = part.find('-');
+        auto first = 0;
+        auto last = 0;
+
+        if (idx == std::string_view::npos) {
+            if (!parse_int(part, first)) {
+                continue;
+            }
+            last = first;
+        } else if (!parse_int(part.substr(0, idx), first) || !parse_int(part.substr(idx + 1), last)) {
+            continue;
+        }
+
+        for (auto cpu = first; cpu <= last; ++cpu) {
+            cpus.emplace_back(cpu);
+        }
+    }
+
+    std::ranges::sort(cpus);
+    const auto [first, last] = std::ranges::unique(cpus);
+    cpus.erase(first, last);
+
+    return cpus;
+}
+
+[[nodiscard]] auto read_cpu_topology() -> std::vector<CpuCore> {
+    const auto sysfs = std::filesystem::path("/sys/devices/system");
+
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    if (::sched_getaffinity(0, sizeof(mask), &mask) != 0) {
+        return {};
+    }
+
+    const auto allowed = [&mask](const int cpu) {
+        return cpu >= 0 && cpu < CPU_SETSIZE && CPU_ISSET(cpu, &mask);
+    };
+
+    // NUMA node of each CPU, everything is on node 0 if there's no information
+    auto cpu_nodes = std::map<int, int>();
+    auto ec = std::error_code();
+    for (const auto &entry : std::filesystem::directory_iterator(sysfs / "node", ec)) {
+        const auto name = entry.path().filename().string();
+        auto node = 0;
+        if (!name.starts_with("node") || !parse_int(std::string_view(name).substr(4), node)) {
+            continue;
+        }
+        for (const auto cpu : parse_cpu_list(read_file(entry.path() / "cpulist"))) {
+            cpu_nodes[cpu] = node;
+        }
+    }
+
+    // Group CPUs by the first of their SMT siblings
+    auto cores = std::map<int, CpuCore>();
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+        if (!allowed(cpu)) {
+            continue;
+        }
+
+        auto siblings = parse_cpu_list(
+            read_file(sysfs / "cpu" / ("cpu" + std::to_string(cpu)) / "topology" / "thread_siblings_list"));
+        std::erase_if(siblings, [&allowed](const int sibling) {
+            return !allowed(sibling);
+        });
+        if (siblings.empty()) {
+            siblings.emplace_back(cpu);
+        }
+
+        auto &core = cores[siblings.front()];
+        core.node = cpu_nodes.contains(cpu) ? cpu_nodes[cpu] : 0;
+        core.cpus = siblings;
+    }
+
+    auto topology = std::vector<CpuCore>();
+    for (auto &[first, core] : cores) {
+        topology.emplace_back(std::move(core));
+    }
+    return topology;
+}
+
+[[nodiscard]] auto make_cpu_slots(const std::vector<CpuCore> &cores,
+                                  const std::size_t num_slots,
+                                  const bool smt,
+                                  const bool numa) -> std::vector<CpuSet> {
+    if (cores.empty() || num_slots == 0) {
+        return {};
+    }
+
+    // Cores grouped by NUMA node, or all together
+    auto groups = std::map<int, std::vector<const CpuCore *>>();
+    for (const auto &core : cores) {
+        groups[numa ? core.node : 0].emplace_back(&core);
+    }
+
+    // Share the slots between the groups in proportion to their size, largest remainder first
+    auto shares = std::vector<std::size_t>();
+    auto remainders = std::vector<std::pair<std::size_t, std::size_t>>();
+    auto assigned = std::size_t(0);
+    for (const auto &[node, group] : groups) {
+        const auto exact = num_slots * group.size();
+        shares.emplace_back(exact / cores.size());
+        remainders.emplace_back(exact % cores.size(), shares.size() - 1);
+        assigned += shares.back();
+    }
+    std::ranges::stable_sort(remainders, std::greater<>(), &std::pair<std::size_t, std::size_t>::first);
+    for (std::size_t i = 0; assigned < num_slots; ++i, ++assigned) {
+        shares[remainders[i % remainders.size()].second]++;
+    }
+
+    auto slots = std::vector<CpuSet>();
+    auto group_idx = std::size_t(0);
+    for (const auto &[node, group] : groups) {
+        const auto num_group_slots = shares[group_idx++];
+
+        for (std::size_t i = 0; i < num_group_slots; ++i) {
+            auto first = i * group.size() / num_group_slots;
+            auto last = (i + 1) * group.size() / num_group_slots;
+
+            // More slots than cores, they'll have to share
+            if (first == last) {
+                first = i % group.size();
+                last = first + 1;
+            }
+
+            auto cpus = CpuSet();
+            for (auto j = first; j < last; ++j) {
+                const auto &core_cpus = group[j]->cpus;
+                if (smt) {
+                    cpus.insert(cpus.end(), core_cpus.begin(), core_cpus.end());
+                } else {
+                    cpus.emplace_back(core_cpus.front());
+                }
+            }
+            slots.emplace_back(std::move(cpus));
+        }
+    }
+
+    return slots;
+}
+
+auto set_affinity(const pid_t pid, const CpuSet &cpus) noexcept -> bool {
+    if (cpus.empty()) {
+        return false;
+    }
+
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    for (const auto cpu : cpus) {
+        if (cpu >= 0 && cpu < CPU_SETSIZE) {
+            CPU_SET(cpu, &mask);
+        }
+    }
+
+    // Threads the engine has already started don't inherit the process' mask, so set each one
+    auto success = true;
+    auto ec = std::error_code();
+    const auto tasks = std::filesystem::path("/proc") / std::to_string(pid) / "task";
+    for (const auto &entry : std::filesystem::directory_iterator(tasks, ec)) {
+        auto tid = 0;
+        if (parse_int(entry.path().filename().string(), tid)) {
+            success &= ::sched_setaffinity(tid, sizeof(mask), &mask) == 0;
+        }
+    }
+
+    if (ec) {
+        return ::sched_setaffinity(pid, sizeof(mask), &mask) == 0;
+    }
+
+    return success;
+}
@@ -0,0 +1,34 @@
+#ifndef ENGINE_AFFINITY_HPP
+#define ENGINE_AFFINITY_HPP
+
+#include <sys/types.h>
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+using CpuSet = std::vector<int>;
+
+// A physical core and the logical CPUs (SMT siblings) that share it
+struct [[nodiscard]] CpuCore {
+    int node = 0;
+    CpuSet cpus;
+};
+
+// Parse a sysfs style CPU list such as "0-3,8,10-11"
+[[nodiscard]] auto parse_cpu_list(const std::string_view str) -> CpuSet;
+
+// The cores this process is allowed to run on, read from sysfs
+[[nodiscard]] auto read_cpu_topology() -> std::vector<CpuCore>;
+
+// Split the cores into disjoint CPU sets, one per slot
+// smt: include every SMT sibling of a core rather than just the first
+// numa: don't let a slot span more than one NUMA node
+[[nodiscard]] auto make_cpu_slots(const std::vector<CpuCore> &cores,
+                                  const std::size_t num_slots,
+                                  const bool smt,
+                                  const bool numa) -> std::vector<CpuSet>;
+
+// Pin every thread of a process to the CPU set
+auto set_affinity(const pid_t pid, const CpuSet &cpus) noexcept -> bool;
+
+#endif
@@ -0,0 +1,86 @@
+/*
+ * C ABI for engines loaded into cutegames as shared libraries
+ *
+ * A plugin exports cutegames_plugin_v2(), returning a table of functions.
+ * The entry point and the table are named after CUTEGAMES_PLUGIN_VERSION and renamed whenever it changes,
+ * plugins built against a different version either aren't found or are refused.
+ * Each engine instance is created with create() and only ever used from one thread at a time,
+ * but separate instances are used from different threads at once.
+ *
+ * Build with something like: cc -shared -fPIC engine.c -o libengine.so
+ */
+
+#ifndef CUTEGAMES_PLUGIN_H
+#define CUTEGAMES_PLUGIN_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CUTEGAMES_PLUGIN_VERSION 2
+
+enum cg_search_type
+{
+    CG_SEARCH_TIME = 0,
+    CG_SEARCH_MOVETIME,
+    CG_SEARCH_DEPTH,
+    CG_SEARCH_NODES,
+};
+
+struct cg_search {
+    int type;
+    int p1time;
+    int p2time;
+    int p1inc;
+    int p2inc;
+    int movetime;
+    int depth;
+    int64_t nodes;
+};
+
+/* Optionally filled in by go(), everything starts at zero */
+struct cg_info {
+    int depth;
+    int seldepth;
+    uint64_t nodes;
+    uint64_t nps;
+    int time;
+    int score;
+    int is_mate;
+    /* Set if score and is_mate were filled in, a search can report a depth without a score */
+    int has_score;
+};
+
+struct cg_plugin_v2 {
+    /* CUTEGAMES_PLUGIN_VERSION the plugin was built against */
+    int version;
+
+    /* Returns NULL on failure */
+    void *(*create)(void);
+    void (*destroy)(void *engine);
+
+    void (*set_option)(void *engine, const char *name, const char *value);
+    void (*newgame)(void *engine);
+
+    /* fen is "startpos" for the game's usual starting position */
+    void (*position)(void *engine, const char *fen, const char *const *moves, size_t num_moves);
+
+    /* Write the chosen move as a null terminated string, returns 0 on success */
+    int (*go)(void *engine, const struct cg_search *search, struct cg_info *info, char *move, size_t size);
+
+    /* Answer a UGI query (p1turn, gameover, result) the same way as the text protocol, returns 0 on success */
+    int (*query)(void *engine, const char *question, char *answer, size_t size);
+};
+
+typedef const struct cg_plugin_v2 *(*cutegames_plugin_v2_fn)(void);
+
+const struct cg_plugin_v2 *cutegames_plugin_v2(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -1,16 +1,26 @@
 #ifndef ENGINE_HPP
 #define ENGINE_HPP
 
+#include <chrono>
+#include <cstdint>
 #include <functional>
+#include <memory>
+#include <optional>
 #include <string>
 #include <string_view>
 #include <unordered_map>
+#include <utility>
+#include <vector>
+#include "../games/game_position.hpp"
+#include "latency.hpp"
+#include "search_info.hpp"
 
 enum class [[nodiscard]] EngineProtocol
 {
     UGI,
     UAI,
     UCI,
+    Plugin,
 };
 
 struct [[nodiscard]] EngineStatistics {
@@ -20,6 +30,25 @@ struct [[nodiscard]] EngineStatistics {
     int draw = 0;
     int crash = 0;
     int flagged = 0;
+    int illegal = 0;
+    // Search info reported by the engine
+    int searches = 0;
+    std::uint64_t depth_total = 0;
+    std::uint64_t nps_total = 0;
+    // Time spent searching
+    std::uint64_t wall_ms_total = 0;
+    std::uint64_t cpu_ms_total = 0;
+    // Round trips to the engine
+    LatencyStats latency;
+};
+
+struct [[nodiscard]] StartupTimes {
+    // Starting the process
+    std::chrono::microseconds spawn = std::chrono::microseconds(0);
+    // Protocol handshake
+    std::chrono::microseconds init = std::chrono::microseconds(0);
+    // Setting options until the first readyok
+    std::chrono::microseconds ready = std::chrono::microseconds(0);
 };
 
 struct [[nodiscard]] EngineSettings {
@@ -40,6 +69,13 @@ struct [[nodiscard]] SearchSettings {
         Nodes,
     };
 
+    // What engines are charged for their searches
+    enum class Timing : int
+    {
+        Wall = 0,
+        Cpu,
+    };
+
     [[nodiscard]] static auto as_time(const int p1t, const int p2t, const int p1i, const int p2i) -> SearchSettings {
         return SearchSettings{.type = Type::Time, .p1time = p1t, .p2time = p2t, .p1inc = p1i, .p2inc = p2i};
     }
@@ -57,6 +93,7 @@ struct [[nodiscard]] SearchSettings {
     }
 
     Type type = Type::Depth;
+    Timing timing = Timing::Wall;
     int p1time = 0;
     int p2time = 0;
     int p1inc = 0;
@@ -71,6 +108,7 @@ class [[nodiscard]] Engine {
    public:
     using callback_type = std::function<void(const std::string_view)>;
     using id_type = std::size_t;
+    using timeout_type = std::optional<std::chrono::milliseconds>;
 
     virtual ~Engine() = default;
 
@@ -78,19 +116,69 @@ class [[nodiscard]] Engine {
         return m_id;
     }
 
+    [[nodiscard]] auto timed_out() const noexcept -> bool {
+        return m_timed_out;
+    }
+
+    [[nodiscard]] auto crashed() const noexcept -> bool {
+        return m_crashed;
+    }
+
+    [[nodiscard]] auto search_info() const noexcept -> const SearchInfo & {
+        return m_search_info;
+    }
+
+    // How long the last search took, measured as close to the pipe as possible
+    [[nodiscard]] auto search_time() const noexcept -> const std::optional<std::chrono::microseconds> & {
+        return m_search_time;
+    }
+
+    // The reply the engine expects, if it gave one with its last bestmove
+    [[nodiscard]] auto ponder_move() const noexcept -> const std::optional<std::string> & {
+        return m_ponder_move;
+    }
+
+    [[nodiscard]] auto startup_times() const noexcept -> const StartupTimes & {
+        return m_startup_times;
+    }
+
+    auto set_startup_times(const StartupTimes &times) noexcept -> void {
+        m_startup_times = times;
+    }
+
+    // Hand over the round trips timed so far and start again, the histograms are too big to copy every game
+    [[nodiscard]] auto take_latency() -> std::shared_ptr<const LatencyStats> {
+        return std::exchange(m_latency, std::make_shared<LatencyStats>());
+    }
+
     [[nodiscard]] virtual auto is_running() -> bool = 0;
 
-    [[nodiscard]] virtual auto go(const SearchSettings &) -> std::string = 0;
+    [[nodiscard]] virtual auto go(const SearchSettings &, const timeout_type) -> std::string = 0;
+
+    // Search the current position on the opponent's time, without waiting for a reply
+    virtual auto go_ponder(const SearchSettings &) -> void {
+    }
+
+    // The opponent played the expected move, the ponder search carries on as a normal one
+    [[nodiscard]] virtual auto ponderhit(const timeout_type) -> std::string {
+        return "0000";
+    }
+
+    // The opponent played something else, abandon the ponder search
+    virtual auto stop_ponder() -> void {
+    }
 
-    [[nodiscard]] virtual auto query_p1turn() -> bool = 0;
+    // An engine that doesn't answer a query or isready within the timeout is marked as timed out
+    [[nodiscard]] virtual auto query_p1turn(const timeout_type) -> bool = 0;
 
-    [[nodiscard]] virtual auto query_gameover() -> bool = 0;
+    [[nodiscard]] virtual auto query_gameover(const timeout_type) -> bool = 0;
 
-    [[nodiscard]] virtual auto query_result() -> std::string = 0;
+    [[nodiscard]] virtual auto query_result(const timeout_type) -> std::string = 0;
 
-    virtual auto init() -> void = 0;
+    // An engine that doesn't finish its handshake within the timeout is marked as timed out
+    virtual auto init(const timeout_type) -> void = 0;
 
-    virtual auto is_ready() -> void = 0;
+    virtual auto is_ready(const timeout_type) -> void = 0;
 
     virtual auto newgame() -> void = 0;
 
@@ -98,10 +186,19 @@ class [[nodiscard]] Engine {
 
     virtual auto stop() -> void = 0;
 
-    virtual auto position(const std::string &, const std::vector<std::string> &) -> void = 0;
+    virtual auto position(const GamePosition &) -> void = 0;
 
     virtual auto set_option(const std::string &, const std::string &) -> void = 0;
 
+    // CPU time the engine has used, if it can be measured
+    [[nodiscard]] virtual auto cpu_time() -> std::optional<std::chrono::nanoseconds> {
+        return {};
+    }
+
+    // Restrict the engine to these CPUs
+    virtual auto set_affinity(const std::vector<int> &) -> void {
+    }
+
    protected:
     Engine() = default;
 
@@ -118,6 +215,21 @@ class [[nodiscard]] Engine {
     callback_type m_send = [](const auto) {
     };
 
+    // Set if the last search, isready or query didn't finish before its deadline
+    bool m_timed_out = false;
+
+    // Set once the engine has exited or closed its pipes
+    bool m_crashed = false;
+
+    // Reported by the engine during its last search
+    SearchInfo m_search_info;
+    std::optional<std::string> m_ponder_move;
+    std::optional<std::chrono::microseconds> m_search_time;
+
+    StartupTimes m_startup_times;
+
+    std::shared_ptr<LatencyStats> m_latency = std::make_shared<LatencyStats>();
+
    private:
     id_type m_id = 0;
 };
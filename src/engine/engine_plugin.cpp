@@ -0,0 +1,139 @@
+#include "engine_plugin.hpp"
+#include <dlfcn.h>
+#include <array>
+#include <chrono>
+#include <stdexcept>
+
+[[nodiscard]] PluginEngine::PluginEngine(const id_type id, const std::string &path) : Engine(id) {
+    // Every instance gets its own reference, the library stays loaded until the last one is gone
+    m_library = ::dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (!m_library) {
+        throw std::runtime_error("Failed to load plugin " + path + ": " + ::dlerror());
+    }
+
+    const auto entry = reinterpret_cast<cutegames_plugin_v2_fn>(::dlsym(m_library, "cutegames_plugin_v2"));
+    m_plugin = entry ? entry() : nullptr;
+
+    if (!m_plugin || m_plugin->version != CUTEGAMES_PLUGIN_VERSION) {
+        ::dlclose(m_library);
+        throw std::runtime_error("Unsupported plugin " + path);
+    }
+
+    m_engine = m_plugin->create();
+
+    if (!m_engine) {
+        ::dlclose(m_library);
+        throw std::runtime_error("Failed to create plugin engine " + path);
+    }
+}
+
+PluginEngine::~PluginEngine() {
+    m_plugin->destroy(m_engine);
+    ::dlclose(m_library);
+}
+
+[[nodiscard]] auto PluginEngine::is_running() -> bool {
+    return true;
+}
+
+[[nodiscard]] auto PluginEngine::go(const SearchSettings &settings, const timeout_type timeout) -> std::string {
+    const auto search = cg_search{
+        .type = static_cast<int>(settings.type),
+        .p1time = settings.p1time,
+        .p2time = settings.p2time,
+        .p1inc = settings.p1inc,
+        .p2inc = settings.p2inc,
+        .movetime = settings.movetime,
+        .depth = settings.ply,
+        .nodes = settings.nodes,
+    };
+    static_assert(static_cast<int>(SearchSettings::Type::Time) == CG_SEARCH_TIME);
+    static_assert(static_cast<int>(SearchSettings::Type::Nodes) == CG_SEARCH_NODES);
+
+    auto info = cg_info{};
+    auto move = std::array<char, 64>{};
+
+    // The search can't be interrupted, but it can still be late
+    const auto t0 = std::chrono::steady_clock::now();
+    const auto err = m_plugin->go(m_engine, &search, &info, move.data(), move.size());
+    const auto t1 = std::chrono::steady_clock::now();
+
+    m_timed_out = timeout && t1 - t0 > *timeout;
+    m_search_time = std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0);
+    m_search_info = SearchInfo{
+        .depth = info.depth,
+        .seldepth = info.seldepth,
+        .nodes = info.nodes,
+        .nps = info.nps,
+        .time = info.time,
+        .score = info.score,
+        .is_mate = info.is_mate != 0,
+        .has_score = info.has_score != 0,
+    };
+
+    if (err != 0) {
+        return "0000";
+    }
+
+    move.back() = '\0';
+    return move.data();
+}
+
+[[nodiscard]] auto PluginEngine::query(const char *question) -> std::string {
+    auto answer = std::array<char, 64>{};
+    if (m_plugin->query(m_engine, question, answer.data(), answer.size()) != 0) {
+        return {};
+    }
+    answer.back() = '\0';
+    return answer.data();
+}
+
+[[nodiscard]] auto PluginEngine::query_p1turn(const timeout_type) -> bool {
+    return query("p1turn") == "true";
+}
+
+[[nodiscard]] auto PluginEngine::query_gameover(const timeout_type) -> bool {
+    return query("gameover") == "true";
+}
+
+[[nodiscard]] auto PluginEngine::query_result(const timeout_type) -> std::string {
+    return query("result");
+}
+
+auto PluginEngine::init(const timeout_type) -> void {
+}
+
+auto PluginEngine::is_ready(const timeout_type) -> void {
+}
+
+auto PluginEngine::newgame() -> void {
+    m_plugin->newgame(m_engine);
+}
+
+auto PluginEngine::quit() -> void {
+}
+
+auto PluginEngine::stop() -> void {
+}
+
+auto PluginEngine::position(const GamePosition &position) -> void {
+    m_move_buffer.clear();
+    for (const auto move : position.moves()) {
+        m_move_buffer += move;
+        m_move_buffer += '\0';
+    }
+
+    // Only take pointers once the buffer has stopped growing
+    m_moves.clear();
+    for (std::size_t i = 0; i < m_move_buffer.size(); i += std::char_traits<char>::length(&m_move_buffer[i]) + 1) {
+        m_moves.emplace_back(&m_move_buffer[i]);
+    }
+
+    const auto &start_fen = position.start_fen();
+    const auto fen = start_fen.empty() ? std::string("startpos") : start_fen;
+    m_plugin->position(m_engine, fen.c_str(), m_moves.data(), m_moves.size());
+}
+
+auto PluginEngine::set_option(const std::string &name, const std::string &value) -> void {
+    m_plugin->set_option(m_engine, name.c_str(), value.c_str());
+}
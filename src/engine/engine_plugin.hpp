@@ -0,0 +1,55 @@
+#ifndef ENGINE_PLUGIN_HPP
+#define ENGINE_PLUGIN_HPP
+
+#include <string>
+#include <vector>
+#include "cutegames_plugin.h"
+#include "engine.hpp"
+
+// An engine in a shared library, called directly on the worker's thread
+class [[nodiscard]] PluginEngine final : public Engine {
+   public:
+    [[nodiscard]] PluginEngine(const id_type id, const std::string &path);
+
+    PluginEngine(const PluginEngine &) = delete;
+
+    auto operator=(const PluginEngine &) -> PluginEngine & = delete;
+
+    ~PluginEngine() override;
+
+    [[nodiscard]] auto is_running() -> bool override;
+
+    [[nodiscard]] auto go(const SearchSettings &settings, const timeout_type timeout) -> std::string override;
+
+    [[nodiscard]] auto query_p1turn(const timeout_type timeout) -> bool override;
+
+    [[nodiscard]] auto query_gameover(const timeout_type timeout) -> bool override;
+
+    [[nodiscard]] auto query_result(const timeout_type timeout) -> std::string override;
+
+    auto init(const timeout_type) -> void override;
+
+    auto is_ready(const timeout_type timeout) -> void override;
+
+    auto newgame() -> void override;
+
+    auto quit() -> void override;
+
+    auto stop() -> void override;
+
+    auto position(const GamePosition &position) -> void override;
+
+    auto set_option(const std::string &name, const std::string &value) -> void override;
+
+   private:
+    [[nodiscard]] auto query(const char *question) -> std::string;
+
+    void *m_library = nullptr;
+    const cg_plugin_v2 *m_plugin = nullptr;
+    void *m_engine = nullptr;
+    // The plugin wants C strings, so the moves are copied out of the history with a terminator each
+    std::string m_move_buffer;
+    std::vector<const char *> m_moves;
+};
+
+#endif
@@ -1,58 +1,448 @@
 #include "engine_process.hpp"
-#include <boost/process.hpp>
+#include <signal.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
 #include <utility>
+#include <utils.hpp>
+#include "affinity.hpp"
 #include "engine.hpp"
+#include "search_info.hpp"
 
-[[nodiscard]] ProcessEngine::ProcessEngine(const id_type id, const std::string &path, const std::string &parameters)
+namespace {
+
+constexpr auto shm_poll_interval = std::chrono::milliseconds(50);
+constexpr auto exit_poll_interval = std::chrono::milliseconds(50);
+constexpr auto shm_handshake_timeout = std::chrono::seconds(5);
+// How long a stopped search gets to send its bestmove when there's no watchdog to say
+constexpr auto default_stop_grace = std::chrono::seconds(1);
+
+}  // namespace
+
+[[nodiscard]] ProcessEngine::ProcessEngine(const id_type id,
+                                           const std::string &path,
+                                           const std::string &parameters,
+                                           StderrLog *stderr_log)
     : Engine(id),
-      m_child(path + (parameters.empty() ? "" : (" " + parameters)),
-              boost::process::std_out > m_out,
-              boost::process::std_in < m_in) {
+      m_process(launch(path, parameters, stderr_log != nullptr)),
+      m_reader(m_process.out) {
+    capture_stderr(stderr_log);
 }
 
 [[nodiscard]] ProcessEngine::ProcessEngine(const id_type id,
                                            const std::string &path,
                                            const std::string &parameters,
                                            callback_type recv,
-                                           callback_type send)
+                                           callback_type send,
+                                           StderrLog *stderr_log)
     : Engine(id, std::move(recv), std::move(send)),
-      m_child(path + (parameters.empty() ? "" : (" " + parameters)),
-              boost::process::std_out > m_out,
-              boost::process::std_in < m_in) {
+      m_process(launch(path, parameters, stderr_log != nullptr)),
+      m_reader(m_process.out) {
+    capture_stderr(stderr_log);
+}
+
+ProcessEngine::~ProcessEngine() {
+    if (m_stderr_log) {
+        m_stderr_log->detach(m_process.err);
+    }
+    terminate(m_process);
+}
+
+auto ProcessEngine::capture_stderr(StderrLog *stderr_log) -> void {
+    if (!stderr_log) {
+        return;
+    }
+
+    try {
+        stderr_log->attach(m_process.err, get_id(), m_process.pid);
+    } catch (...) {
+        // Nothing would drain the pipe, so don't leave the engine to block on it
+        terminate(m_process);
+        throw;
+    }
+
+    m_stderr_log = stderr_log;
 }
 
 [[nodiscard]] auto ProcessEngine::is_running() -> bool {
-    return m_child.running();
+    return ::is_running(m_process);
+}
+
+[[nodiscard]] auto ProcessEngine::cpu_time() -> std::optional<std::chrono::nanoseconds> {
+    return ::cpu_time(m_process);
+}
+
+auto ProcessEngine::set_affinity(const std::vector<int> &cpus) -> void {
+    ::set_affinity(m_process.pid, cpus);
+}
+
+auto ProcessEngine::watch(Watchdog &watchdog) noexcept -> void {
+    m_watchdog = &watchdog;
+}
+
+[[nodiscard]] auto ProcessEngine::go(const SearchSettings &settings, const timeout_type timeout) -> std::string {
+    const auto command = go_command(settings);
+    if (command.empty()) {
+        return {};
+    }
+
+    m_search_info = SearchInfo();
+    send(command);
+
+    const auto t0 = clock_type::now();
+    const auto movestr = wait_for_search(make_deadline(timeout));
+
+    if (!m_timed_out && !m_crashed) {
+        record_latency(LatencyType::Go, t0);
+        record_latency(LatencyType::BestMove, m_last_info);
+    }
+
+    return movestr;
+}
+
+auto ProcessEngine::go_ponder(const SearchSettings &settings) -> void {
+    const auto command = go_command(settings);
+    if (command.empty()) {
+        return;
+    }
+
+    // Whatever the engine reports while pondering counts towards the search if there's a ponderhit
+    m_search_info = SearchInfo();
+
+    // "go ..." becomes "go ponder ..."
+    send("go ponder" + command.substr(2));
+    flush();
+}
+
+[[nodiscard]] auto ProcessEngine::ponderhit(const timeout_type timeout) -> std::string {
+    send("ponderhit");
+
+    const auto t0 = clock_type::now();
+    const auto movestr = wait_for_search(make_deadline(timeout));
+
+    if (!m_timed_out && !m_crashed) {
+        record_latency(LatencyType::Ponderhit, t0);
+        record_latency(LatencyType::BestMove, m_last_info);
+    }
+
+    return movestr;
+}
+
+auto ProcessEngine::stop_ponder() -> void {
+    stop_search();
+}
+
+[[nodiscard]] auto ProcessEngine::wait_for_bestmove(const deadline_type deadline) -> std::string {
+    auto movestr = std::string("0000");
+
+    m_ponder_move.reset();
+    m_search_time.reset();
+    m_last_info = clock_type::now();
+
+    const auto result = wait_for(
+        [this, &movestr](const auto &msg) {
+            if (parse_info(msg, m_search_info)) {
+                m_last_info = clock_type::now();
+                return false;
+            }
+
+            const auto parts = utils::split(msg);
+
+            if (parts.size() < 2 || parts[0] != "bestmove") {
+                return false;
+            }
+
+            movestr = parts[1];
+
+            if (parts.size() >= 4 && parts[2] == "ponder") {
+                m_ponder_move = std::string(parts[3]);
+            }
+
+            return true;
+        },
+        deadline);
+
+    m_timed_out = result == WaitResult::Timeout;
+
+    // From the write of the last command, go or ponderhit, to the read of bestmove
+    if (result == WaitResult::Success) {
+        m_search_time = std::chrono::duration_cast<std::chrono::microseconds>(m_line_time - m_write_time);
+    }
+
+    // Setting up the position is hidden in the search time
+    m_position_sent = false;
+
+    return movestr;
+}
+
+[[nodiscard]] auto ProcessEngine::wait_for_search(const deadline_type deadline) -> std::string {
+    const auto movestr = wait_for_bestmove(deadline);
+
+    if (!m_timed_out || !m_watchdog || m_killed) {
+        return movestr;
+    }
+
+    // Too late to use the move, but an engine left searching can't be trusted with anything else
+    stop_search();
+
+    m_crashed = false;
+    m_timed_out = true;
+
+    return movestr;
+}
+
+auto ProcessEngine::stop_search() -> void {
+    send("stop");
+    static_cast<void>(wait_for_bestmove(make_deadline(m_watchdog ? m_watchdog->grace() : default_stop_grace)));
+
+    if (m_timed_out && !m_killed) {
+        ::kill(m_process.pid, SIGKILL);
+        m_killed = true;
+    }
+}
+
+[[nodiscard]] auto ProcessEngine::make_deadline(const timeout_type timeout) noexcept -> deadline_type {
+    if (!timeout) {
+        return {};
+    }
+    return clock_type::now() + *timeout;
 }
 
-auto ProcessEngine::send(const std::string &msg) -> void {
+auto ProcessEngine::send(const std::string_view msg) -> void {
     m_send(msg);
-    m_in << msg << std::endl;
+    m_pending += msg;
+    m_pending += '\n';
 }
 
-auto ProcessEngine::wait_for(const std::string &msg) -> void {
-    std::string line;
-    while (is_running()) {
-        std::getline(m_out, line);
-        if (line.ends_with('\r')) {
-            line.pop_back();
+auto ProcessEngine::flush() -> void {
+    if (m_pending.empty()) {
+        return;
+    }
+
+    std::size_t written = 0;
+
+    // The ring only fills up if the engine stops reading, so check it's still alive every so often
+    while (m_shm && !m_crashed && written < m_pending.size()) {
+        const auto view = std::string_view(m_pending).substr(written);
+        written += m_shm->write(view, clock_type::now() + shm_poll_interval);
+        if (written < m_pending.size() && !::is_running(m_process)) {
+            m_crashed = !m_killed;
+            break;
         }
-        m_recv(line);
-        if (line == msg) {
+    }
+
+    while (!m_shm && written < m_pending.size()) {
+        const auto num_written = ::write(m_process.in, m_pending.data() + written, m_pending.size() - written);
+
+        if (num_written < 0) {
+            if (errno == EINTR || errno == EAGAIN) {
+                continue;
+            } else if (errno == EPIPE) {
+                m_crashed = !m_killed;
+            }
             break;
         }
+
+        written += static_cast<std::size_t>(num_written);
     }
+
+    // The engine can't have started on anything before now
+    m_write_time = clock_type::now();
+    m_pending.clear();
 }
 
-auto ProcessEngine::wait_for(const std::function<bool(const std::string_view msg)> &func) -> void {
+[[nodiscard]] auto ProcessEngine::is_sent_position(const GamePosition &position) const noexcept -> bool {
+    return m_sent_position == position.command();
+}
+
+[[nodiscard]] auto ProcessEngine::moves_since_sent_position(const GamePosition &position) const noexcept
+    -> std::string_view {
+    return position.moves_after(m_sent_position);
+}
+
+auto ProcessEngine::set_sent_position(const GamePosition &position) -> void {
+    m_position_sent = true;
+    // Reuses the buffer, so following a game costs no allocations
+    m_sent_position = position.command();
+}
+
+auto ProcessEngine::clear_sent_position() noexcept -> void {
+    m_sent_position.clear();
+}
+
+auto ProcessEngine::wait_for(const std::string &msg, const deadline_type deadline) -> WaitResult {
+    return wait_for(
+        [&msg](const std::string_view line) {
+            return line == msg;
+        },
+        deadline);
+}
+
+auto ProcessEngine::wait_for(const std::function<bool(const std::string_view msg)> &func, const deadline_type deadline)
+    -> WaitResult {
+    // A killed engine will never answer
+    if (m_killed) {
+        m_timed_out = true;
+        return WaitResult::Timeout;
+    }
+
+    const auto ticket = arm_watchdog(deadline);
+    const auto result = read_until(func, deadline);
+
+    if (ticket && m_watchdog->disarm(*ticket)) {
+        m_killed = true;
+        m_crashed = false;
+        m_timed_out = true;
+        return WaitResult::Timeout;
+    }
+
+    return result;
+}
+
+[[nodiscard]] auto ProcessEngine::arm_watchdog(const deadline_type deadline) -> std::optional<Watchdog::ticket_type> {
+    if (!m_watchdog) {
+        return {};
+    } else if (deadline) {
+        return m_watchdog->arm(m_process.pid, *deadline + m_watchdog->grace());
+    } else if (m_watchdog->hang_limit().count() > 0) {
+        return m_watchdog->arm(m_process.pid, clock_type::now() + m_watchdog->hang_limit());
+    }
+    return {};
+}
+
+[[nodiscard]] auto ProcessEngine::read_until(const std::function<bool(const std::string_view msg)> &func,
+                                             const deadline_type deadline) -> WaitResult {
+    flush();
+
     std::string line;
-    auto exit = false;
-    while (is_running() && !exit) {
-        std::getline(m_out, line);
-        if (line.ends_with('\r')) {
-            line.pop_back();
+    while (true) {
+        // Children of a killed engine can keep its pipe open, so the watchdog needs us to check on the process itself
+        const auto poll_deadline =
+            m_watchdog ? std::optional(std::min(deadline.value_or(clock_type::time_point::max()),
+                                                clock_type::now() + exit_poll_interval))
+                       : deadline;
+
+        auto result = read_line(line, poll_deadline);
+
+        if (result == WaitResult::Timeout && poll_deadline != deadline) {
+            if (::is_running(m_process)) {
+                continue;
+            }
+            result = WaitResult::Exited;
+        }
+
+        if (result != WaitResult::Success) {
+            m_crashed |= result == WaitResult::Exited;
+            return result;
         }
         m_recv(line);
-        exit = func(line);
+        if (func(line)) {
+            return WaitResult::Success;
+        }
+    }
+}
+
+auto ProcessEngine::wait_for(const LatencyType type, const std::string &msg, const deadline_type deadline)
+    -> WaitResult {
+    const auto t0 = clock_type::now();
+    const auto result = wait_for(msg, deadline);
+    if (result == WaitResult::Success) {
+        record_latency(type, t0);
+    }
+    return result;
+}
+
+auto ProcessEngine::wait_for(const LatencyType type,
+                             const std::function<bool(const std::string_view msg)> &func,
+                             const deadline_type deadline) -> WaitResult {
+    const auto t0 = clock_type::now();
+    const auto result = wait_for(func, deadline);
+    if (result == WaitResult::Success) {
+        record_latency(type, t0);
+    }
+    return result;
+}
+
+auto ProcessEngine::wait_for_reply(const LatencyType type, const std::string &msg, const timeout_type timeout)
+    -> WaitResult {
+    return wait_for_reply(
+        type,
+        [&msg](const std::string_view line) {
+            return line == msg;
+        },
+        timeout);
+}
+
+auto ProcessEngine::wait_for_reply(const LatencyType type,
+                                   const std::function<bool(const std::string_view msg)> &func,
+                                   const timeout_type timeout) -> WaitResult {
+    const auto result = wait_for(type, func, make_deadline(timeout));
+    if (result == WaitResult::Timeout) {
+        m_timed_out = true;
+    }
+    return result;
+}
+
+auto ProcessEngine::record_latency(const LatencyType type, const clock_type::time_point t0) noexcept -> void {
+    const auto dt = std::chrono::duration_cast<LatencyHistogram::duration_type>(clock_type::now() - t0);
+
+    (*m_latency)[static_cast<std::size_t>(type)].record(dt);
+
+    if (m_position_sent) {
+        (*m_latency)[static_cast<std::size_t>(LatencyType::Position)].record(dt);
+        m_position_sent = false;
+    }
+}
+
+[[nodiscard]] auto ProcessEngine::switch_to_shared_memory(std::unique_ptr<ShmTransport> shm) -> bool {
+    // Everything queued so far goes through the pipe, everything after through the rings
+    flush();
+    m_shm = std::move(shm);
+
+    send("isready");
+    const auto result = wait_for("readyok", make_deadline(shm_handshake_timeout));
+
+    // The engine has the segment mapped by now, so the name isn't needed any more
+    m_shm->unlink();
+
+    if (result == WaitResult::Timeout) {
+        m_shm.reset();
+        return false;
+    }
+
+    return result == WaitResult::Success;
+}
+
+[[nodiscard]] auto ProcessEngine::read_line(std::string &line, const deadline_type deadline) -> WaitResult {
+    if (m_shm) {
+        // Don't wait on a ring nobody will ever write to again
+        if (m_crashed) {
+            return WaitResult::Exited;
+        }
+
+        while (true) {
+            // Nothing closes the ring if the engine dies, so check it's still alive every so often
+            const auto next = clock_type::now() + shm_poll_interval;
+            const auto status = m_shm->read_line(line, deadline ? std::min(*deadline, next) : next);
+
+            if (status == ShmTransport::Status::Line) {
+                m_line_time = m_shm->read_time();
+                return WaitResult::Success;
+            } else if (deadline && clock_type::now() >= *deadline) {
+                return WaitResult::Timeout;
+            } else if (!::is_running(m_process)) {
+                return WaitResult::Exited;
+            }
+        }
+    }
+
+    switch (m_reader.read_line(line, deadline)) {
+        case LineReader::Status::Line:
+            m_line_time = m_reader.read_time();
+            return WaitResult::Success;
+        case LineReader::Status::Timeout:
+            return WaitResult::Timeout;
+        default:
+            return WaitResult::Exited;
     }
 }
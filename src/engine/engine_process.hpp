@@ -1,37 +1,151 @@
 #ifndef ENGINE_PROCESS_HPP
 #define ENGINE_PROCESS_HPP
 
-#include <boost/process.hpp>
+#include <chrono>
 #include <functional>
+#include <memory>
+#include <optional>
 #include <string>
 #include <string_view>
+#include <vector>
 #include "engine.hpp"
+#include "launcher.hpp"
+#include "line_reader.hpp"
+#include "shm_transport.hpp"
+#include "stderr_log.hpp"
+#include "watchdog.hpp"
 
 class [[nodiscard]] ProcessEngine : public Engine {
    public:
-    [[nodiscard]] ProcessEngine(const id_type id, const std::string &path, const std::string &parameters);
+    using clock_type = std::chrono::steady_clock;
+    using deadline_type = std::optional<clock_type::time_point>;
+
+    enum class WaitResult
+    {
+        Success = 0,
+        Timeout,
+        Exited,
+    };
+
+    // The engine's stderr is written to the log if there is one, otherwise it's inherited
+    [[nodiscard]] ProcessEngine(const id_type id,
+                                const std::string &path,
+                                const std::string &parameters,
+                                StderrLog *stderr_log = nullptr);
 
     [[nodiscard]] ProcessEngine(const id_type id,
                                 const std::string &path,
                                 const std::string &parameters,
                                 callback_type recv,
-                                callback_type send);
+                                callback_type send,
+                                StderrLog *stderr_log = nullptr);
 
-    ~ProcessEngine() override = default;
+    ProcessEngine(const ProcessEngine &) = delete;
+
+    auto operator=(const ProcessEngine &) -> ProcessEngine & = delete;
+
+    ~ProcessEngine() override;
 
     [[nodiscard]] auto is_running() -> bool override;
 
+    [[nodiscard]] auto go(const SearchSettings &settings, const timeout_type timeout) -> std::string override;
+
+    auto go_ponder(const SearchSettings &settings) -> void override;
+
+    [[nodiscard]] auto ponderhit(const timeout_type timeout) -> std::string override;
+
+    auto stop_ponder() -> void override;
+
+    [[nodiscard]] auto cpu_time() -> std::optional<std::chrono::nanoseconds> override;
+
+    auto set_affinity(const std::vector<int> &cpus) -> void override;
+
+    // Have the watchdog kill the engine if it stops responding
+    auto watch(Watchdog &watchdog) noexcept -> void;
+
    protected:
-    auto send(const std::string &msg) -> void;
+    [[nodiscard]] static auto make_deadline(const timeout_type timeout) noexcept -> deadline_type;
+
+    // The protocol's "go ..." command for these settings, empty if they aren't supported
+    [[nodiscard]] virtual auto go_command(const SearchSettings &settings) const -> std::string = 0;
+
+    // Read search info until the bestmove arrives, adding to whatever the search already reported
+    [[nodiscard]] auto wait_for_bestmove(const deadline_type deadline) -> std::string;
+
+    // As above, but a search that overruns is stopped, and killed if it doesn't stop within the watchdog's grace
+    [[nodiscard]] auto wait_for_search(const deadline_type deadline) -> std::string;
+
+    // Stop the search and wait out its bestmove, an engine that doesn't send one within the grace is killed
+    auto stop_search() -> void;
 
-    auto wait_for(const std::string &msg) -> void;
+    // Queue a command, it isn't written until the next flush
+    auto send(const std::string_view msg) -> void;
 
-    auto wait_for(const std::function<bool(const std::string_view msg)> &func) -> void;
+    // Write every queued command to the engine at once
+    auto flush() -> void;
+
+    auto wait_for(const std::string &msg, const deadline_type deadline = {}) -> WaitResult;
+
+    auto wait_for(const std::function<bool(const std::string_view msg)> &func, const deadline_type deadline = {})
+        -> WaitResult;
+
+    // As above, and time the round trip if the reply arrives
+    auto wait_for(const LatencyType type, const std::string &msg, const deadline_type deadline = {}) -> WaitResult;
+
+    auto wait_for(const LatencyType type,
+                  const std::function<bool(const std::string_view msg)> &func,
+                  const deadline_type deadline = {}) -> WaitResult;
+
+    // As above, but an engine that doesn't reply within the timeout is marked as timed out
+    auto wait_for_reply(const LatencyType type, const std::string &msg, const timeout_type timeout) -> WaitResult;
+
+    auto wait_for_reply(const LatencyType type,
+                        const std::function<bool(const std::string_view msg)> &func,
+                        const timeout_type timeout) -> WaitResult;
+
+    // Was this exact position the last one sent to the engine
+    [[nodiscard]] auto is_sent_position(const GamePosition &position) const noexcept -> bool;
+
+    // The moves played since the position last sent to the engine, empty unless this position follows on from it
+    [[nodiscard]] auto moves_since_sent_position(const GamePosition &position) const noexcept -> std::string_view;
+
+    // Move the conversation over to shared memory, the engine must already have been told the segment's name
+    [[nodiscard]] auto switch_to_shared_memory(std::unique_ptr<ShmTransport> shm) -> bool;
+
+    auto set_sent_position(const GamePosition &position) -> void;
+
+    auto clear_sent_position() noexcept -> void;
+
+    // The position command the engine was last sent, empty if there isn't one
+    std::string m_sent_position;
 
    private:
-    boost::process::opstream m_in;
-    boost::process::ipstream m_out;
-    boost::process::child m_child;
+    [[nodiscard]] auto arm_watchdog(const deadline_type deadline) -> std::optional<Watchdog::ticket_type>;
+
+    [[nodiscard]] auto read_until(const std::function<bool(const std::string_view msg)> &func,
+                                  const deadline_type deadline) -> WaitResult;
+
+    auto capture_stderr(StderrLog *stderr_log) -> void;
+
+    auto record_latency(const LatencyType type, const clock_type::time_point t0) noexcept -> void;
+
+    [[nodiscard]] auto read_line(std::string &line, const deadline_type deadline) -> WaitResult;
+
+    Process m_process;
+    LineReader m_reader;
+    std::string m_pending;
+    StderrLog *m_stderr_log = nullptr;
+    Watchdog *m_watchdog = nullptr;
+    // Set once the engine has been killed for not responding, which counts as a timeout rather than a crash
+    bool m_killed = false;
+    std::unique_ptr<ShmTransport> m_shm;
+    // Set until the engine next replies to something after being sent a new position
+    bool m_position_sent = false;
+    // When the last search reported info
+    clock_type::time_point m_last_info;
+    // When the last queued commands were written, and when the last line was read from the engine
+    clock_type::time_point m_write_time;
+    clock_type::time_point m_line_time;
 };
 
 #endif
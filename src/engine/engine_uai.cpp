@@ -1,75 +1,71 @@
 #include "engine_uai.hpp"
 #include <utility>
-#include <utils.hpp>
 
-[[nodiscard]] UAIEngine::UAIEngine(const id_type id, const std::string &path, const std::string &parameters)
-    : ProcessEngine(id, path, parameters) {
+[[nodiscard]] UAIEngine::UAIEngine(const id_type id,
+                                   const std::string &path,
+                                   const std::string &parameters,
+                                   StderrLog *stderr_log)
+    : ProcessEngine(id, path, parameters, stderr_log) {
 }
 
 [[nodiscard]] UAIEngine::UAIEngine(const id_type id,
                                    const std::string &path,
                                    const std::string &parameters,
                                    callback_type recv,
-                                   callback_type send)
-    : ProcessEngine(id, path, parameters, std::move(recv), std::move(send)) {
+                                   callback_type send,
+                                   StderrLog *stderr_log)
+    : ProcessEngine(id, path, parameters, std::move(recv), std::move(send), stderr_log) {
 }
 
 UAIEngine::~UAIEngine() {
     send("quit");
+    flush();
 }
 
 [[nodiscard]] auto UAIEngine::is_gameover() const noexcept -> bool {
     return true;
 }
 
-auto UAIEngine::init() -> void {
+auto UAIEngine::init(const timeout_type timeout) -> void {
     send("uai");
-    wait_for("uaiok");
+    wait_for_reply(LatencyType::Init, "uaiok", timeout);
 }
 
-auto UAIEngine::is_ready() -> void {
+auto UAIEngine::is_ready(const timeout_type timeout) -> void {
     send("isready");
-    wait_for("readyok");
+    wait_for_reply(LatencyType::IsReady, "readyok", timeout);
 }
 
 auto UAIEngine::newgame() -> void {
     send("uainewgame");
+    clear_sent_position();
 }
 
 auto UAIEngine::quit() -> void {
     send("quit");
+    flush();
 }
 
 auto UAIEngine::stop() -> void {
     send("stop");
+    flush();
 }
 
 auto UAIEngine::set_option(const std::string &name, const std::string &value) -> void {
     send("setoption name " + name + " value " + value);
 }
 
-auto UAIEngine::position(const std::string &start_fen, const std::vector<std::string> &move_history) -> void {
-    auto msg = std::string();
-
-    if (start_fen.empty() || start_fen == "startpos") {
-        msg += "position startpos";
-    } else {
-        msg += "position fen " + start_fen;
+auto UAIEngine::position(const GamePosition &position) -> void {
+    // The engine already has this position
+    if (is_sent_position(position)) {
+        return;
     }
 
-    if (!move_history.empty()) {
-        msg += " moves";
-        for (const auto &move : move_history) {
-            msg += " " + move;
-        }
-    }
-
-    send(msg);
+    send(position.command());
+    set_sent_position(position);
 }
 
-[[nodiscard]] auto UAIEngine::go(const SearchSettings &settings) -> std::string {
-    auto movestr = std::string("0000");
-
+[[nodiscard]] auto UAIEngine::go_command(const SearchSettings &settings) const -> std::string {
     switch (settings.type) {
         case SearchSettings::Type::Time: {
             auto str = std::string();
@@ -78,49 +74,27 @@ auto UAIEngine::position(const std::string &start_fen, const std::vector<std::st
             str += " wtime " + std::to_string(settings.p2time);
             str += " binc " + std::to_string(settings.p1inc);
             str += " winc " + std::to_string(settings.p2inc);
-            send(str);
-            break;
+            return str;
         }
         case SearchSettings::Type::Movetime:
-            send("go movetime " + std::to_string(settings.movetime));
-            break;
+            return "go movetime " + std::to_string(settings.movetime);
         case SearchSettings::Type::Depth:
-            send("go depth " + std::to_string(settings.ply));
-            break;
+            return "go depth " + std::to_string(settings.ply);
         case SearchSettings::Type::Nodes:
-            send("go nodes " + std::to_string(settings.nodes));
-            break;
+            return "go nodes " + std::to_string(settings.nodes);
         default:
             return {};
     }
-
-    wait_for([&movestr](const auto &msg) {
-        const auto parts = utils::split(msg);
-
-        if (parts.size() != 2) {
-            return false;
-        }
-
-        if (parts[0] != "bestmove") {
-            return false;
-        }
-
-        movestr = parts[1];
-
-        return true;
-    });
-
-    return movestr;
 }
 
-[[nodiscard]] auto UAIEngine::query_p1turn() -> bool {
+[[nodiscard]] auto UAIEngine::query_p1turn(const timeout_type) -> bool {
     return false;
 }
 
-[[nodiscard]] auto UAIEngine::query_gameover() -> bool {
+[[nodiscard]] auto UAIEngine::query_gameover(const timeout_type) -> bool {
     return false;
 }
 
-[[nodiscard]] auto UAIEngine::query_result() -> std::string {
+[[nodiscard]] auto UAIEngine::query_result(const timeout_type) -> std::string {
     return "";
 }
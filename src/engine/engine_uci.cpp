@@ -1,75 +1,71 @@
 #include "engine_uci.hpp"
 #include <utility>
-#include <utils.hpp>
 
-[[nodiscard]] UCIEngine::UCIEngine(const id_type id, const std::string &path, const std::string &parameters)
-    : ProcessEngine(id, path, parameters) {
+[[nodiscard]] UCIEngine::UCIEngine(const id_type id,
+                                   const std::string &path,
+                                   const std::string &parameters,
+                                   StderrLog *stderr_log)
+    : ProcessEngine(id, path, parameters, stderr_log) {
 }
 
 [[nodiscard]] UCIEngine::UCIEngine(const id_type id,
                                    const std::string &path,
                                    const std::string &parameters,
                                    callback_type recv,
-                                   callback_type send)
-    : ProcessEngine(id, path, parameters, std::move(recv), std::move(send)) {
+                                   callback_type send,
+                                   StderrLog *stderr_log)
+    : ProcessEngine(id, path, parameters, std::move(recv), std::move(send), stderr_log) {
 }
 
 UCIEngine::~UCIEngine() {
     send("quit");
+    flush();
 }
 
 [[nodiscard]] auto UCIEngine::is_gameover() const noexcept -> bool {
     return true;
 }
 
-auto UCIEngine::init() -> void {
+auto UCIEngine::init(const timeout_type timeout) -> void {
     send("uci");
-    wait_for("uciok");
+    wait_for_reply(LatencyType::Init, "uciok", timeout);
 }
 
-auto UCIEngine::is_ready() -> void {
+auto UCIEngine::is_ready(const timeout_type timeout) -> void {
     send("isready");
-    wait_for("readyok");
+    wait_for_reply(LatencyType::IsReady, "readyok", timeout);
 }
 
 auto UCIEngine::newgame() -> void {
     send("ucinewgame");
+    clear_sent_position();
 }
 
 auto UCIEngine::quit() -> void {
     send("quit");
+    flush();
 }
 
 auto UCIEngine::stop() -> void {
     send("stop");
+    flush();
 }
 
 auto UCIEngine::set_option(const std::string &name, const std::string &value) -> void {
     send("setoption name " + name + " value " + value);
 }
 
-auto UCIEngine::position(const std::string &start_fen, const std::vector<std::string> &move_history) -> void {
-    auto msg = std::string();
-
-    if (start_fen.empty() || start_fen == "startpos") {
-        msg += "position startpos";
-    } else {
-        msg += "position fen " + start_fen;
+auto UCIEngine::position(const GamePosition &position) -> void {
+    // The engine already has this position
+    if (is_sent_position(position)) {
+        return;
     }
 
-    if (!move_history.empty()) {
-        msg += " moves";
-        for (const auto &move : move_history) {
-            msg += " " + move;
-        }
-    }
-
-    send(msg);
+    send(position.command());
+    set_sent_position(position);
 }
 
-[[nodiscard]] auto UCIEngine::go(const SearchSettings &settings) -> std::string {
-    auto movestr = std::string("0000");
-
+[[nodiscard]] auto UCIEngine::go_command(const SearchSettings &settings) const -> std::string {
     switch (settings.type) {
         case SearchSettings::Type::Time: {
             auto str = std::string();
@@ -78,49 +74,27 @@ auto UCIEngine::position(const std::string &start_fen, const std::vector<std::st
             str += " btime " + std::to_string(settings.p2time);
             str += " winc " + std::to_string(settings.p1inc);
             str += " binc " + std::to_string(settings.p2inc);
-            send(str);
-            break;
+            return str;
         }
         case SearchSettings::Type::Movetime:
-            send("go movetime " + std::to_string(settings.movetime));
-            break;
+            return "go movetime " + std::to_string(settings.movetime);
         case SearchSettings::Type::Depth:
-            send("go depth " + std::to_string(settings.ply));
-            break;
+            return "go depth " + std::to_string(settings.ply);
         case SearchSettings::Type::Nodes:
-            send("go nodes " + std::to_string(settings.nodes));
-            break;
+            return "go nodes " + std::to_string(settings.nodes);
         default:
             return {};
     }
-
-    wait_for([&movestr](const auto &msg) {
-        const auto parts = utils::split(msg);
-
-        if (parts.size() != 2) {
-            return false;
-        }
-
-        if (parts[0] != "bestmove") {
-            return false;
-        }
-
-        movestr = parts[1];
-
-        return true;
-    });
-
-    return movestr;
 }
 
-[[nodiscard]] auto UCIEngine::query_p1turn() -> bool {
+[[nodiscard]] auto UCIEngine::query_p1turn(const timeout_type) -> bool {
     return false;
 }
 
-[[nodiscard]] auto UCIEngine::query_gameover() -> bool {
+[[nodiscard]] auto UCIEngine::query_gameover(const timeout_type) -> bool {
     return false;
 }
 
-[[nodiscard]] auto UCIEngine::query_result() -> std::string {
+[[nodiscard]] auto UCIEngine::query_result(const timeout_type) -> std::string {
     return "";
 }
@@ -6,21 +6,25 @@
 
 class [[nodiscard]] UCIEngine final : public ProcessEngine {
    public:
-    [[nodiscard]] UCIEngine(const id_type id, const std::string &path, const std::string &parameters);
+    [[nodiscard]] UCIEngine(const id_type id,
+                            const std::string &path,
+                            const std::string &parameters,
+                            StderrLog *stderr_log = nullptr);
 
     [[nodiscard]] UCIEngine(const id_type id,
                             const std::string &path,
                             const std::string &parameters,
                             callback_type recv,
-                            callback_type send);
+                            callback_type send,
+                            StderrLog *stderr_log = nullptr);
 
     ~UCIEngine() override;
 
     [[nodiscard]] auto is_gameover() const noexcept -> bool;
 
-    auto init() -> void override;
+    auto init(const timeout_type timeout) -> void override;
 
-    auto is_ready() -> void override;
+    auto is_ready(const timeout_type timeout) -> void override;
 
     auto newgame() -> void override;
 
@@ -28,17 +32,18 @@ class [[nodiscard]] UCIEngine final : public ProcessEngine {
 
     auto stop() -> void override;
 
-    auto position(const std::string &start_fen, const std::vector<std::string> &move_history) -> void override;
+    auto position(const GamePosition &position) -> void override;
 
     auto set_option(const std::string &name, const std::string &value) -> void override;
 
-    [[nodiscard]] auto go(const SearchSettings &settings) -> std::string override;
+    [[nodiscard]] auto query_p1turn(const timeout_type timeout) -> bool override;
 
-    [[nodiscard]] auto query_p1turn() -> bool override;
+    [[nodiscard]] auto query_gameover(const timeout_type timeout) -> bool override;
 
-    [[nodiscard]] auto query_gameover() -> bool override;
+    [[nodiscard]] auto query_result(const timeout_type timeout) -> std::string override;
 
-    [[nodiscard]] auto query_result() -> std::string override;
+   protected:
+    [[nodiscard]] auto go_command(const SearchSettings &settings) const -> std::string override;
 };
 
 #endif
@@ -1,75 +1,125 @@
 #include "engine_ugi.hpp"
+#include <stdexcept>
 #include <utility>
 #include <utils.hpp>
 
-[[nodiscard]] UGIEngine::UGIEngine(const id_type id, const std::string &path, const std::string &parameters)
-    : ProcessEngine(id, path, parameters) {
+[[nodiscard]] UGIEngine::UGIEngine(const id_type id,
+                                   const std::string &path,
+                                   const std::string &parameters,
+                                   StderrLog *stderr_log)
+    : ProcessEngine(id, path, parameters, stderr_log) {
 }
 
 [[nodiscard]] UGIEngine::UGIEngine(const id_type id,
                                    const std::string &path,
                                    const std::string &parameters,
                                    callback_type recv,
-                                   callback_type send)
-    : ProcessEngine(id, path, parameters, std::move(recv), std::move(send)) {
+                                   callback_type send,
+                                   StderrLog *stderr_log)
+    : ProcessEngine(id, path, parameters, std::move(recv), std::move(send), stderr_log) {
 }
 
 UGIEngine::~UGIEngine() {
     send("quit");
+    flush();
 }
 
 [[nodiscard]] auto UGIEngine::is_gameover() const noexcept -> bool {
     return true;
 }
 
-auto UGIEngine::init() -> void {
+auto UGIEngine::init(const timeout_type timeout) -> void {
     send("ugi");
-    wait_for("ugiok");
+
+    const auto result = wait_for_reply(
+        LatencyType::Init,
+        [this](const auto &msg) {
+            const auto parts = utils::split(msg);
+
+            if (parts.size() >= 3 && parts[0] == "option" && parts[1] == "name") {
+                if (parts[2] == "UGI_PositionDelta") {
+                    m_position_delta = true;
+                } else if (parts[2] == "UGI_QueryState") {
+                    m_query_state = true;
+                } else if (parts[2] == "UGI_SharedMemory") {
+                    m_shared_memory = true;
+                }
+            }
+
+            return msg == "ugiok";
+        },
+        timeout);
+
+    // Whoever started the engine gives up on it, so there's nothing to set up
+    if (result != WaitResult::Success) {
+        return;
+    }
+
+    if (m_position_delta) {
+        send("setoption name UGI_PositionDelta value true");
+    }
+
+    if (m_query_state) {
+        send("setoption name UGI_QueryState value true");
+    }
+
+    if (m_shared_memory) {
+        // Not being able to create the segment isn't fatal, the pipes still work
+        try {
+            auto shm = ShmTransport::create();
+            send("setoption name UGI_SharedMemory value " + shm->name());
+            m_shared_memory = switch_to_shared_memory(std::move(shm));
+        } catch (const std::runtime_error &) {
+            m_shared_memory = false;
+        }
+    }
 }
 
-auto UGIEngine::is_ready() -> void {
+auto UGIEngine::is_ready(const timeout_type timeout) -> void {
     send("isready");
-    wait_for("readyok");
+    wait_for_reply(LatencyType::IsReady, "readyok", timeout);
 }
 
 auto UGIEngine::newgame() -> void {
     send("uginewgame");
+    clear_sent_position();
+    m_state.reset();
 }
 
 auto UGIEngine::quit() -> void {
     send("quit");
+    flush();
 }
 
 auto UGIEngine::stop() -> void {
     send("stop");
+    flush();
 }
 
 auto UGIEngine::set_option(const std::string &name, const std::string &value) -> void {
     send("setoption name " + name + " value " + value);
 }
 
-auto UGIEngine::position(const std::string &start_fen, const std::vector<std::string> &move_history) -> void {
-    auto msg = std::string();
-
-    if (start_fen.empty() || start_fen == "startpos") {
-        msg += "position startpos";
-    } else {
-        msg += "position fen " + start_fen;
+auto UGIEngine::position(const GamePosition &position) -> void {
+    // The engine already has this position
+    if (is_sent_position(position)) {
+        return;
     }
 
-    if (!move_history.empty()) {
-        msg += " moves";
-        for (const auto &move : move_history) {
-            msg += " " + move;
-        }
+    if (const auto moves = moves_since_sent_position(position); m_position_delta && !moves.empty()) {
+        // Only send the moves played since the engine's last position
+        auto msg = std::string("position moves");
+        msg += moves;
+        send(msg);
+    } else {
+        send(position.command());
     }
 
-    send(msg);
+    set_sent_position(position);
+    m_state.reset();
 }
 
-[[nodiscard]] auto UGIEngine::go(const SearchSettings &settings) -> std::string {
-    auto movestr = std::string("0000");
-
+[[nodiscard]] auto UGIEngine::go_command(const SearchSettings &settings) const -> std::string {
     switch (settings.type) {
         case SearchSettings::Type::Time: {
             auto str = std::string();
@@ -78,109 +128,146 @@ auto UGIEngine::position(const std::string &start_fen, const std::vector<std::st
             str += " p2time " + std::to_string(settings.p2time);
             str += " p1inc " + std::to_string(settings.p1inc);
             str += " p2inc " + std::to_string(settings.p2inc);
-            send(str);
-            break;
+            return str;
         }
         case SearchSettings::Type::Movetime:
-            send("go movetime " + std::to_string(settings.movetime));
-            break;
+            return "go movetime " + std::to_string(settings.movetime);
         case SearchSettings::Type::Depth:
-            send("go depth " + std::to_string(settings.ply));
-            break;
+            return "go depth " + std::to_string(settings.ply);
         case SearchSettings::Type::Nodes:
-            send("go nodes " + std::to_string(settings.nodes));
-            break;
+            return "go nodes " + std::to_string(settings.nodes);
         default:
             return {};
     }
+}
+
+[[nodiscard]] auto UGIEngine::query_state(const timeout_type timeout) -> State {
+    if (m_state) {
+        return *m_state;
+    }
 
-    wait_for([&movestr](const auto &msg) {
-        const auto parts = utils::split(msg);
+    send("query state");
 
-        if (parts.size() != 2) {
-            return false;
-        }
+    auto state = State();
 
-        if (parts[0] != "bestmove") {
-            return false;
-        }
+    wait_for_reply(
+        LatencyType::Query,
+        [&state](const auto &msg) {
+            const auto parts = utils::split(msg);
+
+            if (parts.size() != 4) {
+                return false;
+            }
+
+            if (parts[0] != "response") {
+                return false;
+            }
 
-        movestr = parts[1];
+            state.p1turn = parts[1] == "true";
+            state.gameover = parts[2] == "true";
+            state.result = parts[3];
 
-        return true;
-    });
+            return true;
+        },
+        timeout);
 
-    return movestr;
+    // Don't keep the default answer if the engine died or went quiet before replying
+    if (!crashed() && !timed_out()) {
+        m_state = state;
+    }
+
+    return state;
 }
 
-[[nodiscard]] auto UGIEngine::query_p1turn() -> bool {
+[[nodiscard]] auto UGIEngine::query_p1turn(const timeout_type timeout) -> bool {
+    if (m_query_state) {
+        return query_state(timeout).p1turn;
+    }
+
     send("query p1turn");
 
     auto is_p1 = false;
 
-    wait_for([&is_p1](const auto &msg) {
-        const auto parts = utils::split(msg);
+    wait_for_reply(
+        LatencyType::Query,
+        [&is_p1](const auto &msg) {
+            const auto parts = utils::split(msg);
 
-        if (parts.size() != 2) {
-            return false;
-        }
+            if (parts.size() != 2) {
+                return false;
+            }
 
-        if (parts[0] != "response") {
-            return false;
-        }
+            if (parts[0] != "response") {
+                return false;
+            }
 
-        is_p1 = parts[1] == "true";
+            is_p1 = parts[1] == "true";
 
-        return true;
-    });
+            return true;
+        },
+        timeout);
 
     return is_p1;
 }
 
-[[nodiscard]] auto UGIEngine::query_gameover() -> bool {
+[[nodiscard]] auto UGIEngine::query_gameover(const timeout_type timeout) -> bool {
+    if (m_query_state) {
+        return query_state(timeout).gameover;
+    }
+
     send("query gameover");
 
     auto is_gameover = false;
 
-    wait_for([&is_gameover](const auto &msg) {
-        const auto parts = utils::split(msg);
+    wait_for_reply(
+        LatencyType::Query,
+        [&is_gameover](const auto &msg) {
+            const auto parts = utils::split(msg);
 
-        if (parts.size() != 2) {
-            return false;
-        }
+            if (parts.size() != 2) {
+                return false;
+            }
 
-        if (parts[0] != "response") {
-            return false;
-        }
+            if (parts[0] != "response") {
+                return false;
+            }
 
-        is_gameover = parts[1] == "true";
+            is_gameover = parts[1] == "true";
 
-        return true;
-    });
+            return true;
+        },
+        timeout);
 
     return is_gameover;
 }
 
-[[nodiscard]] auto UGIEngine::query_result() -> std::string {
+[[nodiscard]] auto UGIEngine::query_result(const timeout_type timeout) -> std::string {
+    if (m_query_state) {
+        return query_state(timeout).result;
+    }
+
     send("query result");
 
     std::string result;
 
-    wait_for([&result](const auto &msg) {
-        const auto parts = utils::split(msg);
+    wait_for_reply(
+        LatencyType::Query,
+        [&result](const auto &msg) {
+            const auto parts = utils::split(msg);
 
-        if (parts.size() != 2) {
-            return false;
-        }
+            if (parts.size() != 2) {
+                return false;
+            }
 
-        if (parts[0] != "response") {
-            return false;
-        }
+            if (parts[0] != "response") {
+                return false;
+            }
 
-        result = parts[1];
+            result = parts[1];
 
-        return true;
-    });
+            return true;
+        },
+        timeout);
 
     return result;
 }
@@ -1,26 +1,31 @@
 #ifndef ENGINE_UGI_HPP
 #define ENGINE_UGI_HPP
 
+#include <optional>
 #include <string>
 #include "engine_process.hpp"
 
 class [[nodiscard]] UGIEngine final : public ProcessEngine {
    public:
-    [[nodiscard]] UGIEngine(const id_type id, const std::string &path, const std::string &parameters);
+    [[nodiscard]] UGIEngine(const id_type id,
+                            const std::string &path,
+                            const std::string &parameters,
+                            StderrLog *stderr_log = nullptr);
 
     [[nodiscard]] UGIEngine(const id_type id,
                             const std::string &path,
                             const std::string &parameters,
                             callback_type recv,
-                            callback_type send);
+                            callback_type send,
+                            StderrLog *stderr_log = nullptr);
 
     ~UGIEngine() override;
 
     [[nodiscard]] auto is_gameover() const noexcept -> bool;
 
-    auto init() -> void override;
+    auto init(const timeout_type timeout) -> void override;
 
-    auto is_ready() -> void override;
+    auto is_ready(const timeout_type timeout) -> void override;
 
     auto newgame() -> void override;
 
@@ -28,17 +33,36 @@ class [[nodiscard]] UGIEngine final : public ProcessEngine {
 
     auto stop() -> void override;
 
-    auto position(const std::string &start_fen, const std::vector<std::string> &move_history) -> void override;
+    auto position(const GamePosition &position) -> void override;
 
     auto set_option(const std::string &name, const std::string &value) -> void override;
 
-    [[nodiscard]] auto go(const SearchSettings &settings) -> std::string override;
+    [[nodiscard]] auto query_p1turn(const timeout_type timeout) -> bool override;
+
+    [[nodiscard]] auto query_gameover(const timeout_type timeout) -> bool override;
+
+    [[nodiscard]] auto query_result(const timeout_type timeout) -> std::string override;
+
+   protected:
+    [[nodiscard]] auto go_command(const SearchSettings &settings) const -> std::string override;
+
+   private:
+    struct State {
+        bool p1turn = false;
+        bool gameover = false;
+        std::string result;
+    };
 
-    [[nodiscard]] auto query_p1turn() -> bool override;
+    // Answer every query about the current position with one round trip
+    [[nodiscard]] auto query_state(const timeout_type timeout) -> State;
 
-    [[nodiscard]] auto query_gameover() -> bool override;
+    // Protocol extensions, enabled if the engine advertises them during the handshake
+    bool m_position_delta = false;
+    bool m_query_state = false;
+    bool m_shared_memory = false;
 
-    [[nodiscard]] auto query_result() -> std::string override;
+    // Reply to "query state" for the position last sent
+    std::optional<State> m_state;
 };
 
 #endif
@@ -0,0 +1,125 @@
+#ifndef ENGINE_LATENCY_HPP
+#define ENGINE_LATENCY_HPP
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// Round trips timed for every engine
+enum class [[nodiscard]] LatencyType : std::size_t
+{
+    // Protocol handshake
+    Init = 0,
+    IsReady,
+    // First reply to something other than a search after a new position, which includes the engine setting it up
+    Position,
+    // From go to bestmove
+    Go,
+    // From ponderhit to bestmove, the part of a ponder search played on our own time
+    Ponderhit,
+    // From the last info line to bestmove, which leaves out the thinking
+    BestMove,
+    Query,
+};
+
+inline constexpr std::size_t num_latency_types = 7;
+
+[[nodiscard]] constexpr auto latency_name(const LatencyType type) noexcept -> std::string_view {
+    switch (type) {
+        case LatencyType::Init:
+            return "init";
+        case LatencyType::IsReady:
+            return "isready";
+        case LatencyType::Position:
+            return "position";
+        case LatencyType::Go:
+            return "go";
+        case LatencyType::Ponderhit:
+            return "ponderhit";
+        case LatencyType::BestMove:
+            return "bestmove";
+        case LatencyType::Query:
+            return "query";
+        default:
+            return "unknown";
+    }
+}
+
+// Log-linear buckets in the style of HdrHistogram
+// Values below 2 * sub_buckets are exact, larger ones are kept to within 1/sub_buckets
+class [[nodiscard]] LatencyHistogram {
+   public:
+    using duration_type = std::chrono::microseconds;
+
+    static constexpr int sub_bits = 4;
+    static constexpr std::size_t sub_buckets = std::size_t(1) << sub_bits;
+    static constexpr std::size_t num_buckets = (64 - sub_bits + 1) * sub_buckets;
+
+    auto record(const duration_type dt) noexcept -> void {
+        const auto value = static_cast<std::uint64_t>(std::max<duration_type::rep>(dt.count(), 0));
+        m_counts[index(value)]++;
+        m_count++;
+        m_max = std::max(m_max, value);
+    }
+
+    auto merge(const LatencyHistogram &other) noexcept -> void {
+        for (std::size_t i = 0; i < num_buckets; ++i) {
+            m_counts[i] += other.m_counts[i];
+        }
+        m_count += other.m_count;
+        m_max = std::max(m_max, other.m_max);
+    }
+
+    [[nodiscard]] auto count() const noexcept -> std::uint64_t {
+        return m_count;
+    }
+
+    [[nodiscard]] auto max() const noexcept -> duration_type {
+        return duration_type(m_max);
+    }
+
+    // The smallest value that p percent of the samples are at or below, rounded up to the end of its bucket
+    [[nodiscard]] auto percentile(const double p) const noexcept -> duration_type {
+        if (m_count == 0) {
+            return duration_type(0);
+        }
+
+        const auto wanted = std::clamp(static_cast<std::uint64_t>(p / 100.0 * static_cast<double>(m_count) + 0.5),
+                                       std::uint64_t(1),
+                                       m_count);
+
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < num_buckets; ++i) {
+            seen += m_counts[i];
+            if (seen >= wanted) {
+                return duration_type(std::min(highest_equivalent(i), m_max));
+            }
+        }
+
+        return duration_type(m_max);
+    }
+
+    [[nodiscard]] static constexpr auto index(const std::uint64_t value) noexcept -> std::size_t {
+        const auto shift = std::max(static_cast<int>(std::bit_width(value)) - 1 - sub_bits, 0);
+        return static_cast<std::size_t>(shift) * sub_buckets + static_cast<std::size_t>(value >> shift);
+    }
+
+    [[nodiscard]] static constexpr auto highest_equivalent(const std::size_t idx) noexcept -> std::uint64_t {
+        const auto shift = idx < 2 * sub_buckets ? 0 : idx / sub_buckets - 1;
+        const auto mantissa = static_cast<std::uint64_t>(idx - shift * sub_buckets);
+        return ((mantissa + 1) << shift) - 1;
+    }
+
+   private:
+    std::array<std::uint64_t, num_buckets> m_counts = {};
+    std::uint64_t m_count = 0;
+    std::uint64_t m_max = 0;
+};
+
+using LatencyStats = std::array<LatencyHistogram, num_latency_types>;
+
+#endif
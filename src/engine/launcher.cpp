@@ -0,0 +1,145 @@
+#include "launcher.hpp"
+#include <fcntl.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <utils.hpp>
+#include <vector>
+
+extern char **environ;
+
+[[nodiscard]] auto launch(const std::string &path, const std::string &parameters, const bool capture_stderr)
+    -> Process {
+    auto args = std::vector<std::string>{path};
+    for (const auto &arg : utils::split(parameters)) {
+        args.emplace_back(arg);
+    }
+
+    auto argv = std::vector<char *>();
+    for (auto &arg : args) {
+        argv.emplace_back(arg.data());
+    }
+    argv.emplace_back(nullptr);
+
+    // Close-on-exec so engines started by other threads don't inherit these
+    int in[2];
+    int out[2];
+    if (::pipe2(in, O_CLOEXEC) != 0) {
+        throw std::runtime_error("Failed to create pipe for " + path);
+    }
+    if (::pipe2(out, O_CLOEXEC) != 0) {
+        ::close(in[0]);
+        ::close(in[1]);
+        throw std::runtime_error("Failed to create pipe for " + path);
+    }
+    // Only our end of stderr is non-blocking, the engine's writes still block on a full pipe
+    int err[2] = {-1, -1};
+    if (capture_stderr && (::pipe2(err, O_CLOEXEC) != 0 || ::fcntl(err[0], F_SETFL, O_NONBLOCK) != 0)) {
+        ::close(in[0]);
+        ::close(in[1]);
+        ::close(out[0]);
+        ::close(out[1]);
+        if (err[0] != -1) {
+            ::close(err[0]);
+            ::close(err[1]);
+        }
+        throw std::runtime_error("Failed to create pipe for " + path);
+    }
+
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_adddup2(&actions, in[0], STDIN_FILENO);
+    posix_spawn_file_actions_adddup2(&actions, out[1], STDOUT_FILENO);
+    if (capture_stderr) {
+        posix_spawn_file_actions_adddup2(&actions, err[1], STDERR_FILENO);
+    }
+
+    auto process = Process();
+    const auto result = ::posix_spawnp(&process.pid, path.c_str(), &actions, nullptr, argv.data(), environ);
+    posix_spawn_file_actions_destroy(&actions);
+
+    // The child has its own copies now
+    ::close(in[0]);
+    ::close(out[1]);
+    if (capture_stderr) {
+        ::close(err[1]);
+    }
+
+    if (result != 0) {
+        ::close(in[1]);
+        ::close(out[0]);
+        if (capture_stderr) {
+            ::close(err[0]);
+        }
+        throw std::runtime_error("Failed to start " + path + ": " + std::strerror(result));
+    }
+
+    process.in = in[1];
+    process.out = out[0];
+    process.err = err[0];
+
+    return process;
+}
+
+auto terminate(Process &process) noexcept -> void {
+    if (process.in != -1) {
+        ::close(process.in);
+        process.in = -1;
+    }
+
+    if (process.out != -1) {
+        ::close(process.out);
+        process.out = -1;
+    }
+
+    if (process.err != -1) {
+        ::close(process.err);
+        process.err = -1;
+    }
+
+    if (process.pid > 0) {
+        if (::waitpid(process.pid, nullptr, WNOHANG) == 0) {
+            ::kill(process.pid, SIGKILL);
+            while (::waitpid(process.pid, nullptr, 0) < 0 && errno == EINTR) {
+            }
+        }
+        process.pid = -1;
+    }
+}
+
+[[nodiscard]] auto is_running(Process &process) noexcept -> bool {
+    if (process.pid <= 0) {
+        return false;
+    }
+
+    // Leave an exited process to be reaped by terminate(), so its pid can't be reused by something else before then
+    auto info = siginfo_t();
+    if (::waitid(P_PID, static_cast<id_t>(process.pid), &info, WEXITED | WNOHANG | WNOWAIT) != 0) {
+        return false;
+    }
+
+    return info.si_pid == 0;
+}
+
+[[nodiscard]] auto cpu_time(const Process &process) noexcept -> std::optional<std::chrono::nanoseconds> {
+    if (process.pid <= 0) {
+        return {};
+    }
+
+    clockid_t clock;
+    if (::clock_getcpuclockid(process.pid, &clock) != 0) {
+        return {};
+    }
+
+    timespec ts;
+    if (::clock_gettime(clock, &ts) != 0) {
+        return {};
+    }
+
+    return std::chrono::seconds(ts.tv_sec) + std::chrono::nanoseconds(ts.tv_nsec);
+}
@@ -0,0 +1,33 @@
+#ifndef ENGINE_LAUNCHER_HPP
+#define ENGINE_LAUNCHER_HPP
+
+#include <sys/types.h>
+#include <chrono>
+#include <optional>
+#include <string>
+
+struct [[nodiscard]] Process {
+    pid_t pid = -1;
+    // Write end of the process' stdin
+    int in = -1;
+    // Read end of the process' stdout
+    int out = -1;
+    // Non-blocking read end of the process' stderr, if it was captured
+    int err = -1;
+};
+
+// Start a process with posix_spawn, parameters are split on spaces and passed as argv without a shell
+// stderr is inherited unless it's captured, in which case something has to keep reading it
+[[nodiscard]] auto launch(const std::string &path, const std::string &parameters, const bool capture_stderr = false)
+    -> Process;
+
+// Close the pipes and reap the process, killing it if it hasn't already exited
+auto terminate(Process &process) noexcept -> void;
+
+// Doesn't reap the process, so the pid stays valid until terminate()
+[[nodiscard]] auto is_running(Process &process) noexcept -> bool;
+
+// CPU time used so far by every thread of the process
+[[nodiscard]] auto cpu_time(const Process &process) noexcept -> std::optional<std::chrono::nanoseconds>;
+
+#endif
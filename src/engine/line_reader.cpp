@@ -0,0 +1,60 @@
+#include "line_reader.hpp"
+#include <poll.h>
+#include <unistd.h>
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <limits>
+
+[[nodiscard]] auto LineReader::read_line(std::string &line, const deadline_type deadline) -> Status {
+    while (true) {
+        // Return a complete line if we already have one buffered
+        const auto idx = m_buffer.find('\n');
+        if (idx != std::string::npos) {
+            line.assign(m_buffer, 0, idx);
+            m_buffer.erase(0, idx + 1);
+            if (line.ends_with('\r')) {
+                line.pop_back();
+            }
+            m_line_time = m_read_time;
+            return Status::Line;
+        }
+
+        // Wait for more output, but no later than the deadline
+        auto timeout_ms = -1;
+        if (deadline) {
+            const auto remaining = std::chrono::ceil<std::chrono::milliseconds>(*deadline - clock_type::now());
+            if (remaining.count() <= 0) {
+                return Status::Timeout;
+            }
+            timeout_ms = static_cast<int>(std::min<long long>(remaining.count(), std::numeric_limits<int>::max()));
+        }
+
+        auto pfd = pollfd{.fd = m_fd, .events = POLLIN, .revents = 0};
+        const auto num_ready = ::poll(&pfd, 1, timeout_ms);
+
+        if (num_ready < 0 && errno != EINTR) {
+            return Status::Closed;
+        } else if (num_ready <= 0) {
+            // Interrupted by a signal or out of time, either way the deadline is checked again at the top
+            continue;
+        }
+
+        std::array<char, 4096> buffer;
+        const auto num_read = ::read(m_fd, buffer.data(), buffer.size());
+        // Only read when there's no complete line buffered, so any line found next ends in these bytes
+        m_read_time = clock_type::now();
+
+        if (num_read == 0) {
+            m_buffer.clear();
+            return Status::Closed;
+        } else if (num_read < 0) {
+            if (errno == EINTR || errno == EAGAIN) {
+                continue;
+            }
+            return Status::Closed;
+        }
+
+        m_buffer.append(buffer.data(), static_cast<std::size_t>(num_read));
+    }
+}
@@ -0,0 +1,41 @@
+#ifndef ENGINE_LINE_READER_HPP
+#define ENGINE_LINE_READER_HPP
+
+#include <chrono>
+#include <optional>
+#include <string>
+
+// Splits the output of a pipe into lines, waiting for each one no later than its deadline
+class [[nodiscard]] LineReader {
+   public:
+    using clock_type = std::chrono::steady_clock;
+    using deadline_type = std::optional<clock_type::time_point>;
+
+    enum class Status
+    {
+        Line = 0,
+        Timeout,
+        Closed,
+    };
+
+    // The fd is borrowed, whoever owns it closes it
+    [[nodiscard]] explicit LineReader(const int fd) noexcept : m_fd(fd) {
+    }
+
+    // A partial line is kept until the rest of it arrives, and dropped if the pipe closes first
+    // Trailing carriage returns are removed
+    [[nodiscard]] auto read_line(std::string &line, const deadline_type deadline) -> Status;
+
+    // When the bytes ending the last line returned by read_line() were read from the pipe
+    [[nodiscard]] auto read_time() const noexcept -> clock_type::time_point {
+        return m_line_time;
+    }
+
+   private:
+    int m_fd = -1;
+    std::string m_buffer;
+    clock_type::time_point m_read_time;
+    clock_type::time_point m_line_time;
+};
+
+#endif
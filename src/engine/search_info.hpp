@@ -0,0 +1,74 @@
+#ifndef ENGINE_SEARCH_INFO_HPP
+#define ENGINE_SEARCH_INFO_HPP
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <string_view>
+
+struct [[nodiscard]] SearchInfo {
+    int depth = 0;
+    int seldepth = 0;
+    std::uint64_t nodes = 0;
+    std::uint64_t nps = 0;
+    int time = 0;
+    int score = 0;
+    bool is_mate = false;
+    bool has_score = false;
+};
+
+// Update info with the fields found in an "info ..." line from the engine
+// Fields missing from the line keep their previous values
+// Returns false if the line isn't an info line
+[[nodiscard]] inline auto parse_info(const std::string_view line, SearchInfo &info) noexcept -> bool {
+    auto rest = line;
+
+    const auto next_token = [&rest]() noexcept -> std::string_view {
+        const auto first = rest.find_first_not_of(' ');
+        if (first == std::string_view::npos) {
+            rest = {};
+            return {};
+        }
+        rest.remove_prefix(first);
+        const auto last = std::min(rest.find(' '), rest.size());
+        const auto token = rest.substr(0, last);
+        rest.remove_prefix(last);
+        return token;
+    };
+
+    const auto parse_number = [](const std::string_view token, auto &value) noexcept {
+        std::from_chars(token.data(), token.data() + token.size(), value);
+    };
+
+    if (next_token() != "info") {
+        return false;
+    }
+
+    for (auto token = next_token(); !token.empty(); token = next_token()) {
+        if (token == "depth") {
+            parse_number(next_token(), info.depth);
+        } else if (token == "seldepth") {
+            parse_number(next_token(), info.seldepth);
+        } else if (token == "nodes") {
+            parse_number(next_token(), info.nodes);
+        } else if (token == "nps") {
+            parse_number(next_token(), info.nps);
+        } else if (token == "time") {
+            parse_number(next_token(), info.time);
+        } else if (token == "score") {
+            const auto type = next_token();
+            if (type == "cp" || type == "mate") {
+                parse_number(next_token(), info.score);
+                info.is_mate = type == "mate";
+                info.has_score = true;
+            }
+        } else if (token == "pv" || token == "string") {
+            // Everything after these is free text
+            break;
+        }
+    }
+
+    return true;
+}
+
+#endif
@@ -0,0 +1,178 @@
+#include "shm_transport.hpp"
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <ctime>
+#include <stdexcept>
+
+namespace {
+
+std::atomic<std::uint32_t> segment_counter = 0;
+
+auto futex_wait(std::atomic<std::uint32_t> &word,
+                const std::uint32_t expected,
+                const ShmTransport::clock_type::time_point deadline) -> void {
+    const auto remaining = std::max(deadline - ShmTransport::clock_type::now(), ShmTransport::clock_type::duration(0));
+    const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(remaining).count();
+    const auto timeout = timespec{.tv_sec = static_cast<time_t>(ns / 1'000'000'000), .tv_nsec = ns % 1'000'000'000};
+    ::syscall(SYS_futex, reinterpret_cast<std::uint32_t *>(&word), FUTEX_WAIT, expected, &timeout, nullptr, 0);
+}
+
+// Wake the other side if it's asleep on this ring
+auto notify(ShmRing &ring) -> void {
+    ring.seq.fetch_add(1);
+    if (ring.waiting.exchange(0) != 0) {
+        ::syscall(SYS_futex, reinterpret_cast<std::uint32_t *>(&ring.seq), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+    }
+}
+
+// Sleep until the ring changes from what was seen, or the deadline passes
+auto wait(ShmRing &ring, const std::uint32_t seen, const ShmTransport::clock_type::time_point deadline) -> void {
+    ring.waiting.store(1);
+    if (ring.seq.load() != seen) {
+        return;
+    }
+    futex_wait(ring.seq, seen, deadline);
+}
+
+[[nodiscard]] auto map(const int fd) -> void * {
+    auto *ptr = ::mmap(nullptr, sizeof(ShmRing) * 2, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    return ptr == MAP_FAILED ? nullptr : ptr;
+}
+
+}  // namespace
+
+[[nodiscard]] auto ShmTransport::create() -> std::unique_ptr<ShmTransport> {
+    const auto name = "/cutegames-" + std::to_string(::getpid()) + "-" + std::to_string(segment_counter++);
+
+    const auto fd = ::shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd < 0) {
+        throw std::runtime_error("Failed to create shared memory " + name);
+    }
+
+    // Zero filled, so every ring starts out empty
+    auto *ptr = ::ftruncate(fd, sizeof(Segment)) == 0 ? map(fd) : nullptr;
+    ::close(fd);
+
+    if (!ptr) {
+        ::shm_unlink(name.c_str());
+        throw std::runtime_error("Failed to map shared memory " + name);
+    }
+
+    return std::unique_ptr<ShmTransport>(new ShmTransport(name, static_cast<Segment *>(ptr), Role::Host, true));
+}
+
+[[nodiscard]] auto ShmTransport::open(const std::string &name, const Role role) -> std::unique_ptr<ShmTransport> {
+    const auto fd = ::shm_open(name.c_str(), O_RDWR, 0);
+    if (fd < 0) {
+        throw std::runtime_error("Failed to open shared memory " + name);
+    }
+
+    auto *ptr = map(fd);
+    ::close(fd);
+
+    if (!ptr) {
+        throw std::runtime_error("Failed to map shared memory " + name);
+    }
+
+    return std::unique_ptr<ShmTransport>(new ShmTransport(name, static_cast<Segment *>(ptr), role, false));
+}
+
+ShmTransport::ShmTransport(std::string name, Segment *segment, const Role role, const bool owner)
+    : m_name(std::move(name)),
+      m_segment(segment),
+      m_out(role == Role::Host ? &segment->to_engine : &segment->from_engine),
+      m_in(role == Role::Host ? &segment->from_engine : &segment->to_engine),
+      m_linked(owner) {
+}
+
+ShmTransport::~ShmTransport() {
+    unlink();
+    ::munmap(m_segment, sizeof(Segment));
+}
+
+auto ShmTransport::unlink() noexcept -> void {
+    if (m_linked) {
+        ::shm_unlink(m_name.c_str());
+        m_linked = false;
+    }
+}
+
+[[nodiscard]] auto ShmTransport::write(const std::string_view data, const clock_type::time_point deadline)
+    -> std::size_t {
+    auto &ring = *m_out;
+    std::size_t written = 0;
+
+    while (written < data.size()) {
+        const auto seen = ring.seq.load();
+        const auto head = ring.head.load(std::memory_order_relaxed);
+        const auto tail = ring.tail.load(std::memory_order_acquire);
+        const auto space = ShmRing::capacity - (head - tail);
+
+        if (space == 0) {
+            if (clock_type::now() >= deadline) {
+                break;
+            }
+            wait(ring, seen, deadline);
+            continue;
+        }
+
+        // Copy in at most two pieces, either side of the end of the buffer
+        const auto size = std::min<std::size_t>(space, data.size() - written);
+        const auto start = head % ShmRing::capacity;
+        const auto first = std::min<std::size_t>(size, ShmRing::capacity - start);
+        std::memcpy(ring.data + start, data.data() + written, first);
+        std::memcpy(ring.data, data.data() + written + first, size - first);
+
+        ring.head.store(head + static_cast<std::uint32_t>(size), std::memory_order_release);
+        notify(ring);
+        written += size;
+    }
+
+    return written;
+}
+
+[[nodiscard]] auto ShmTransport::read_line(std::string &line, const clock_type::time_point deadline) -> Status {
+    auto &ring = *m_in;
+
+    while (true) {
+        // Return a complete line if we already have one buffered
+        const auto idx = m_partial.find('\n');
+        if (idx != std::string::npos) {
+            line.assign(m_partial, 0, idx);
+            m_partial.erase(0, idx + 1);
+            if (line.ends_with('\r')) {
+                line.pop_back();
+            }
+            return Status::Line;
+        }
+
+        const auto seen = ring.seq.load();
+        const auto tail = ring.tail.load(std::memory_order_relaxed);
+        const auto head = ring.head.load(std::memory_order_acquire);
+
+        if (head == tail) {
+            if (clock_type::now() >= deadline) {
+                return Status::Timeout;
+            }
+            wait(ring, seen, deadline);
+            continue;
+        }
+
+        const auto size = head - tail;
+        const auto start = tail % ShmRing::capacity;
+        const auto first = std::min<std::size_t>(size, ShmRing::capacity - start);
+        m_partial.append(ring.data + start, first);
+        m_partial.append(ring.data, size - first);
+        // Only read when there's no complete line buffered, so any line found next ends in these bytes
+        m_read_time = clock_type::now();
+
+        ring.tail.store(head, std::memory_order_release);
+        notify(ring);
+    }
+}
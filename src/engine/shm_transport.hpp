@@ -0,0 +1,92 @@
+#ifndef ENGINE_SHM_TRANSPORT_HPP
+#define ENGINE_SHM_TRANSPORT_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+// A single producer, single consumer byte ring living in shared memory
+struct ShmRing {
+    static constexpr std::uint32_t capacity = 1 << 16;
+
+    // Only ever increase, the position in data is the value modulo the capacity
+    alignas(64) std::atomic<std::uint32_t> head;
+    alignas(64) std::atomic<std::uint32_t> tail;
+    // Futex word, bumped whenever data is written or space is freed
+    alignas(64) std::atomic<std::uint32_t> seq;
+    // Set by a side that's about to sleep on seq
+    std::atomic<std::uint32_t> waiting;
+    alignas(64) char data[capacity];
+};
+
+static_assert(std::atomic<std::uint32_t>::is_always_lock_free);
+static_assert(sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t));
+
+// Lines exchanged with an engine through a pair of rings in a POSIX shared memory segment
+class [[nodiscard]] ShmTransport {
+   public:
+    using clock_type = std::chrono::steady_clock;
+
+    enum class Role
+    {
+        Host = 0,
+        Engine,
+    };
+
+    enum class Status
+    {
+        Line = 0,
+        Timeout,
+    };
+
+    // Create a new segment for an engine to open by name
+    [[nodiscard]] static auto create() -> std::unique_ptr<ShmTransport>;
+
+    // Open a segment created by someone else
+    [[nodiscard]] static auto open(const std::string &name, const Role role) -> std::unique_ptr<ShmTransport>;
+
+    ShmTransport(const ShmTransport &) = delete;
+
+    auto operator=(const ShmTransport &) -> ShmTransport & = delete;
+
+    ~ShmTransport();
+
+    [[nodiscard]] auto name() const noexcept -> const std::string & {
+        return m_name;
+    }
+
+    // Remove the name once the engine has opened the segment, the memory stays until both sides unmap it
+    auto unlink() noexcept -> void;
+
+    // Returns the number of bytes written before the deadline
+    [[nodiscard]] auto write(const std::string_view data, const clock_type::time_point deadline) -> std::size_t;
+
+    [[nodiscard]] auto read_line(std::string &line, const clock_type::time_point deadline) -> Status;
+
+    // When the last line returned by read_line() was taken out of the ring
+    [[nodiscard]] auto read_time() const noexcept -> clock_type::time_point {
+        return m_read_time;
+    }
+
+   private:
+    struct Segment {
+        ShmRing to_engine;
+        ShmRing from_engine;
+    };
+
+    ShmTransport(std::string name, Segment *segment, const Role role, const bool owner);
+
+    std::string m_name;
+    Segment *m_segment = nullptr;
+    ShmRing *m_out = nullptr;
+    ShmRing *m_in = nullptr;
+    bool m_linked = false;
+    std::string m_partial;
+    clock_type::time_point m_read_time;
+};
+
+#endif
@@ -0,0 +1,245 @@
+#include "stderr_log.hpp"
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <stdexcept>
+#include <string_view>
+
+namespace {
+
+// Lines longer than this are split rather than buffered
+constexpr std::size_t max_line_length = 4096;
+
+// The epoll event id of the wake fd, sources are numbered from 1
+constexpr std::uint64_t wake_id = 0;
+
+// Enough to empty a full pipe, an engine that keeps writing can't hold a detach up for longer than that
+constexpr int max_detach_reads = 16;
+
+[[nodiscard]] auto file_name(const std::string &name) -> std::string {
+    auto str = std::string();
+    for (const auto c : name) {
+        const auto is_safe = std::isalnum(static_cast<unsigned char>(c)) || c == '-' || c == '_' || c == '.';
+        str += is_safe ? c : '_';
+    }
+    return str + ".log";
+}
+
+[[nodiscard]] auto open_log(const std::string &path, const int flags) -> int {
+    return ::open(path.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC | flags, 0644);
+}
+
+}  // namespace
+
+[[nodiscard]] StderrLog::StderrLog(const std::string &directory,
+                                   const std::vector<std::string> &names,
+                                   const std::size_t max_bytes,
+                                   const std::size_t num_backups)
+    : m_max_bytes(max_bytes), m_num_backups(num_backups) {
+    std::filesystem::create_directories(directory);
+
+    for (std::size_t i = 0; i < names.size(); ++i) {
+        auto file = std::make_unique<LogFile>();
+        file->path = (std::filesystem::path(directory) / file_name(names[i])).string();
+        file->fd = open_log(file->path, O_TRUNC);
+        if (file->fd < 0) {
+            throw std::runtime_error("Failed to open log file " + file->path);
+        }
+        m_files.emplace_back(std::move(file));
+    }
+
+    m_epoll_fd = ::epoll_create1(EPOLL_CLOEXEC);
+    m_wake_fd = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+
+    if (m_epoll_fd < 0 || m_wake_fd < 0) {
+        throw std::runtime_error("Failed to create stderr log");
+    }
+
+    auto event = epoll_event{.events = EPOLLIN, .data = {.u64 = wake_id}};
+    ::epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, m_wake_fd, &event);
+
+    m_thread = std::thread([this] {
+        run();
+    });
+}
+
+StderrLog::~StderrLog() {
+    m_quit = true;
+
+    const auto one = std::uint64_t{1};
+    [[maybe_unused]] const auto written = ::write(m_wake_fd, &one, sizeof(one));
+
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+
+    // Keep whatever was left unterminated
+    for (auto &[id, source] : m_sources) {
+        if (!source.partial.empty()) {
+            write_line(*source.file, source.prefix, source.partial);
+        }
+    }
+
+    for (auto &file : m_files) {
+        ::close(file->fd);
+    }
+
+    ::close(m_wake_fd);
+    ::close(m_epoll_fd);
+}
+
+auto StderrLog::attach(const int fd, const std::size_t engine_id, const pid_t pid) -> void {
+    auto *file = m_files.at(engine_id).get();
+
+    std::scoped_lock lock(m_mutex);
+
+    const auto id = m_next_id++;
+    m_sources[id] = Source{fd, file, "[" + std::to_string(pid) + "] ", {}};
+
+    auto event = epoll_event{.events = EPOLLIN, .data = {.u64 = id}};
+    if (::epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, fd, &event) != 0) {
+        m_sources.erase(id);
+        throw std::runtime_error("Failed to attach engine to stderr log");
+    }
+}
+
+auto StderrLog::detach(const int fd) -> void {
+    std::scoped_lock lock(m_mutex);
+
+    const auto iter = std::find_if(m_sources.begin(), m_sources.end(), [fd](const auto &pair) {
+        return pair.second.fd == fd;
+    });
+    if (iter == m_sources.end()) {
+        return;
+    }
+
+    ::epoll_ctl(m_epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+
+    // Keep anything written just before the engine was told to quit
+    auto pfd = pollfd{.fd = fd, .events = POLLIN, .revents = 0};
+    for (int i = 0;
+         i < max_detach_reads && ::poll(&pfd, 1, 0) > 0 && (pfd.revents & POLLIN) && read_some(iter->second);
+         ++i) {
+    }
+
+    if (!iter->second.partial.empty()) {
+        write_line(*iter->second.file, iter->second.prefix, iter->second.partial);
+    }
+
+    m_sources.erase(iter);
+}
+
+[[nodiscard]] auto StderrLog::path(const std::size_t engine_id) const -> const std::string & {
+    return m_files.at(engine_id)->path;
+}
+
+auto StderrLog::run() -> void {
+    std::array<epoll_event, 64> events;
+
+    while (!m_quit) {
+        const auto num_events = ::epoll_wait(m_epoll_fd, events.data(), static_cast<int>(events.size()), -1);
+
+        if (num_events < 0 && errno != EINTR) {
+            break;
+        }
+
+        for (int i = 0; i < num_events; ++i) {
+            const auto id = events[i].data.u64;
+
+            if (id == wake_id) {
+                continue;
+            }
+
+            // Held while writing so a detach can't close the fd underneath us
+            std::scoped_lock lock(m_mutex);
+
+            // Detached since the event was reported, its fd may already belong to someone else
+            const auto iter = m_sources.find(id);
+            if (iter == m_sources.end()) {
+                continue;
+            }
+
+            if (!read_some(iter->second)) {
+                // The engine closed its end of the pipe
+                if (!iter->second.partial.empty()) {
+                    write_line(*iter->second.file, iter->second.prefix, iter->second.partial);
+                }
+                ::epoll_ctl(m_epoll_fd, EPOLL_CTL_DEL, iter->second.fd, nullptr);
+                m_sources.erase(iter);
+            }
+        }
+    }
+}
+
+[[nodiscard]] auto StderrLog::read_some(Source &source) -> bool {
+    std::array<char, 4096> buffer;
+    const auto num_read = ::read(source.fd, buffer.data(), buffer.size());
+
+    if (num_read == 0) {
+        return false;
+    } else if (num_read < 0) {
+        // Nothing to read after all
+        return errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK;
+    }
+
+    source.partial.append(buffer.data(), static_cast<std::size_t>(num_read));
+
+    auto start = std::size_t(0);
+    auto idx = source.partial.find('\n');
+    while (idx != std::string::npos) {
+        write_line(*source.file, source.prefix, std::string_view(source.partial).substr(start, idx - start));
+        start = idx + 1;
+        idx = source.partial.find('\n', start);
+    }
+    source.partial.erase(0, start);
+
+    if (source.partial.size() >= max_line_length) {
+        write_line(*source.file, source.prefix, source.partial);
+        source.partial.clear();
+    }
+
+    return true;
+}
+
+auto StderrLog::write_line(LogFile &file, const std::string &prefix, const std::string_view line) -> void {
+    auto str = prefix;
+    str += line;
+    if (str.ends_with('\r')) {
+        str.pop_back();
+    }
+    str += '\n';
+
+    if (m_max_bytes > 0 && file.size > 0 && file.size + str.size() > m_max_bytes) {
+        rotate(file);
+    }
+
+    // A failed write loses the line, but mustn't stall anything
+    const auto num_written = ::write(file.fd, str.data(), str.size());
+    if (num_written > 0) {
+        file.size += static_cast<std::size_t>(num_written);
+    }
+}
+
+auto StderrLog::rotate(LogFile &file) -> void {
+    ::close(file.fd);
+
+    if (m_num_backups > 0) {
+        for (auto i = m_num_backups - 1; i > 0; --i) {
+            std::rename((file.path + "." + std::to_string(i)).c_str(),
+                        (file.path + "." + std::to_string(i + 1)).c_str());
+        }
+        std::rename(file.path.c_str(), (file.path + ".1").c_str());
+    }
+
+    file.fd = open_log(file.path, O_TRUNC);
+    file.size = 0;
+}
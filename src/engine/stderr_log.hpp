@@ -0,0 +1,77 @@
+#ifndef ENGINE_STDERR_LOG_HPP
+#define ENGINE_STDERR_LOG_HPP
+
+#include <sys/types.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Drains the stderr of every attached engine on a background thread into one rotating log file per engine
+// Engines never block on a full pipe, and memory use is bounded by a partial line per engine
+class [[nodiscard]] StderrLog {
+   public:
+    // Files are named after the engines, indexed by engine id
+    [[nodiscard]] StderrLog(const std::string &directory,
+                            const std::vector<std::string> &names,
+                            const std::size_t max_bytes,
+                            const std::size_t num_backups);
+
+    StderrLog(const StderrLog &) = delete;
+
+    auto operator=(const StderrLog &) -> StderrLog & = delete;
+
+    ~StderrLog();
+
+    // Lines are prefixed with the pid so instances of the same engine can be told apart
+    // The fd must be non-blocking
+    auto attach(const int fd, const std::size_t engine_id, const pid_t pid) -> void;
+
+    // Must be called before the fd is closed
+    auto detach(const int fd) -> void;
+
+    [[nodiscard]] auto path(const std::size_t engine_id) const -> const std::string &;
+
+   private:
+    struct LogFile {
+        std::string path;
+        int fd = -1;
+        std::size_t size = 0;
+    };
+
+    struct Source {
+        int fd = -1;
+        LogFile *file = nullptr;
+        std::string prefix;
+        std::string partial;
+    };
+
+    auto run() -> void;
+
+    // Read what's available and log every complete line, returns false once the pipe is closed
+    [[nodiscard]] auto read_some(Source &source) -> bool;
+
+    auto write_line(LogFile &file, const std::string &prefix, const std::string_view line) -> void;
+
+    // Move log to log.1, log.1 to log.2 and so on, then start an empty log
+    auto rotate(LogFile &file) -> void;
+
+    std::size_t m_max_bytes = 0;
+    std::size_t m_num_backups = 0;
+    std::vector<std::unique_ptr<LogFile>> m_files;
+    int m_epoll_fd = -1;
+    int m_wake_fd = -1;
+    std::mutex m_mutex;
+    // Keyed by an id that's never reused, so a stale event for a closed fd can't be mistaken for a newer source
+    std::unordered_map<std::uint64_t, Source> m_sources;
+    std::uint64_t m_next_id = 1;
+    std::atomic<bool> m_quit = false;
+    std::thread m_thread;
+};
+
+#endif
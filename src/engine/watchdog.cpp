@@ -0,0 +1,76 @@
+#include "watchdog.hpp"
+#include <signal.h>
+
+[[nodiscard]] Watchdog::Watchdog(const std::chrono::milliseconds grace, const std::chrono::milliseconds hang_limit)
+    : m_grace(grace), m_hang_limit(hang_limit) {
+    m_thread = std::thread([this] {
+        run();
+    });
+}
+
+Watchdog::~Watchdog() {
+    {
+        std::scoped_lock lock(m_mutex);
+        m_quit = true;
+    }
+    m_cv.notify_one();
+
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+[[nodiscard]] auto Watchdog::arm(const pid_t pid, const clock_type::time_point deadline) -> ticket_type {
+    auto ticket = ticket_type();
+
+    {
+        std::scoped_lock lock(m_mutex);
+        ticket = m_next++;
+        m_entries[ticket] = Entry{pid, deadline, false};
+    }
+    m_cv.notify_one();
+
+    return ticket;
+}
+
+[[nodiscard]] auto Watchdog::disarm(const ticket_type ticket) -> bool {
+    std::scoped_lock lock(m_mutex);
+
+    const auto iter = m_entries.find(ticket);
+    if (iter == m_entries.end()) {
+        return false;
+    }
+
+    const auto fired = iter->second.fired;
+    m_entries.erase(iter);
+    return fired;
+}
+
+auto Watchdog::run() -> void {
+    std::unique_lock lock(m_mutex);
+
+    while (!m_quit) {
+        // Find the next deadline, there are only ever a few waits armed at once so a scan is fine
+        auto next = std::optional<clock_type::time_point>();
+        for (const auto &[ticket, entry] : m_entries) {
+            if (!entry.fired && (!next || entry.deadline < *next)) {
+                next = entry.deadline;
+            }
+        }
+
+        if (next) {
+            m_cv.wait_until(lock, *next);
+        } else {
+            m_cv.wait(lock);
+        }
+
+        // The process can't have been reaped yet, whoever armed the ticket is still waiting on it
+        const auto now = clock_type::now();
+        for (auto &[ticket, entry] : m_entries) {
+            if (!entry.fired && entry.deadline <= now) {
+                ::kill(entry.pid, SIGKILL);
+                entry.fired = true;
+            }
+        }
+    }
+}
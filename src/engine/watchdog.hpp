@@ -0,0 +1,61 @@
+#ifndef ENGINE_WATCHDOG_HPP
+#define ENGINE_WATCHDOG_HPP
+
+#include <sys/types.h>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+// Kills engines that are still being waited on after their deadline, so a hung engine can't hold up a worker
+class [[nodiscard]] Watchdog {
+   public:
+    using clock_type = std::chrono::steady_clock;
+    using ticket_type = std::uint64_t;
+
+    // grace is how long a search gets to answer a stop, hang_limit bounds waits that have no deadline of their own
+    [[nodiscard]] Watchdog(const std::chrono::milliseconds grace, const std::chrono::milliseconds hang_limit);
+
+    Watchdog(const Watchdog &) = delete;
+
+    auto operator=(const Watchdog &) -> Watchdog & = delete;
+
+    ~Watchdog();
+
+    [[nodiscard]] auto grace() const noexcept -> std::chrono::milliseconds {
+        return m_grace;
+    }
+
+    [[nodiscard]] auto hang_limit() const noexcept -> std::chrono::milliseconds {
+        return m_hang_limit;
+    }
+
+    // SIGKILL the process if it's still armed at the deadline
+    [[nodiscard]] auto arm(const pid_t pid, const clock_type::time_point deadline) -> ticket_type;
+
+    // Returns true if the process was killed, it can't be killed any more once this returns
+    [[nodiscard]] auto disarm(const ticket_type ticket) -> bool;
+
+   private:
+    struct Entry {
+        pid_t pid = -1;
+        clock_type::time_point deadline;
+        bool fired = false;
+    };
+
+    auto run() -> void;
+
+    std::chrono::milliseconds m_grace;
+    std::chrono::milliseconds m_hang_limit;
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::map<ticket_type, Entry> m_entries;
+    ticket_type m_next = 0;
+    bool m_quit = false;
+    std::thread m_thread;
+};
+
+#endif
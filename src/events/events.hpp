@@ -3,6 +3,7 @@
 
 #include <chrono>
 #include <libevents.hpp>
+#include <memory>
 #include <string>
 #include <thread>
 #include <utility>
@@ -20,6 +21,7 @@ enum EventID : libevents::Event::EventIDType
     zEngineLoaded,
     zEngineUnloaded,
     zEngineCrashed,
+    zEngineLatency,
     // Match
     zMatchFinished,
     // Threads
@@ -96,8 +98,8 @@ struct [[nodiscard]] ThreadFinished final : public libevents::Event {
 };
 
 struct [[nodiscard]] EngineCreated final : public libevents::Event {
-    [[nodiscard]] EngineCreated(const std::size_t a, std::string b, std::string c)
-        : engine_id(a), path(std::move(b)), name(std::move(c)) {
+    [[nodiscard]] EngineCreated(const std::size_t a, std::string b, std::string c, const StartupTimes t = {})
+        : engine_id(a), path(std::move(b)), name(std::move(c)), startup(t) {
     }
 
     [[nodiscard]] auto id() const noexcept -> libevents::Event::EventIDType override {
@@ -107,6 +109,31 @@ struct [[nodiscard]] EngineCreated final : public libevents::Event {
     std::size_t engine_id = 0;
     std::string path;
     std::string name;
+    StartupTimes startup;
+};
+
+struct [[nodiscard]] EngineCrashed final : public libevents::Event {
+    [[nodiscard]] explicit EngineCrashed(const std::size_t a) : engine_id(a) {
+    }
+
+    [[nodiscard]] auto id() const noexcept -> libevents::Event::EventIDType override {
+        return EventID::zEngineCrashed;
+    }
+
+    std::size_t engine_id = 0;
+};
+
+struct [[nodiscard]] EngineLatency final : public libevents::Event {
+    [[nodiscard]] EngineLatency(const std::size_t a, std::shared_ptr<const LatencyStats> b)
+        : engine_id(a), latency(std::move(b)) {
+    }
+
+    [[nodiscard]] auto id() const noexcept -> libevents::Event::EventIDType override {
+        return EventID::zEngineLatency;
+    }
+
+    std::size_t engine_id = 0;
+    std::shared_ptr<const LatencyStats> latency;
 };
 
 struct [[nodiscard]] EngineDestroyed final : public libevents::Event {
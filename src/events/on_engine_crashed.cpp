@@ -0,0 +1,21 @@
+#include <iostream>
+#include "colour.hpp"
+#include "events.hpp"
+#include "on_events.hpp"
+#include "print.hpp"
+
+auto on_engine_crashed(const std::shared_ptr<libevents::Event> &event,
+                       const MatchSettings &settings,
+                       std::vector<EngineStatistics> &engine_stats) noexcept -> void {
+    const auto e = std::static_pointer_cast<EngineCrashed>(event);
+
+    engine_stats.at(e->engine_id).crash++;
+
+    if (settings.verbose) {
+        std::scoped_lock<std::mutex> lock(print_mutex);
+        std::cout << termcolor::blue;
+        std::cout << "[verbose] ";
+        std::cout << termcolor::reset;
+        std::cout << "Engine " << e->engine_id << " crashed\n";
+    }
+}
@@ -0,0 +1,12 @@
+#include "events.hpp"
+#include "on_events.hpp"
+
+auto on_engine_latency(const std::shared_ptr<libevents::Event> &event,
+                       std::vector<EngineStatistics> &engine_stats) noexcept -> void {
+    const auto e = std::static_pointer_cast<EngineLatency>(event);
+
+    auto &latency = engine_stats.at(e->engine_id).latency;
+    for (std::size_t i = 0; i < latency.size(); ++i) {
+        latency[i].merge((*e->latency)[i]);
+    }
+}
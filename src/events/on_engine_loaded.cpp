@@ -10,12 +10,18 @@ auto on_engine_loaded(const std::shared_ptr<libevents::Event> &event,
     const auto e = std::static_pointer_cast<EngineCreated>(event);
 
     stats.num_engine_loads++;
+    stats.engine_startup.spawn += e->startup.spawn;
+    stats.engine_startup.init += e->startup.init;
+    stats.engine_startup.ready += e->startup.ready;
 
     if (settings.verbose) {
         std::scoped_lock<std::mutex> lock(print_mutex);
         std::cout << termcolor::blue;
         std::cout << "[verbose] ";
         std::cout << termcolor::reset;
-        std::cout << "Load engine " << e->engine_id << "\n";
+        std::cout << "Load engine " << e->engine_id;
+        std::cout << " spawn " << e->startup.spawn.count() << "us";
+        std::cout << " init " << e->startup.init.count() << "us";
+        std::cout << " ready " << e->startup.ready.count() << "us\n";
     }
 }
@@ -24,6 +24,12 @@ auto on_engine_unloaded(const std::shared_ptr<libevents::Event> &,
                         const MatchSettings &,
                         MatchStatistics &) noexcept -> void;
 
+auto on_engine_crashed(const std::shared_ptr<libevents::Event> &,
+                       const MatchSettings &,
+                       std::vector<EngineStatistics> &) noexcept -> void;
+
+auto on_engine_latency(const std::shared_ptr<libevents::Event> &, std::vector<EngineStatistics> &) noexcept -> void;
+
 auto on_match_finished(const std::shared_ptr<libevents::Event> &, bool &) noexcept -> void;
 
 #endif
@@ -108,6 +108,26 @@ auto on_game_finished(const std::shared_ptr<libevents::Event> &event,
             break;
     }
 
+    if (e->reason == AdjudicationReason::Timeout) {
+        engine_stats.at(e->result == GameResult::Player1Win ? e->engine2_id : e->engine1_id).flagged++;
+    } else if (e->reason == AdjudicationReason::IllegalMove) {
+        engine_stats.at(e->result == GameResult::Player1Win ? e->engine2_id : e->engine1_id).illegal++;
+    }
+
+    for (const auto &info : e->game->move_info()) {
+        auto &engine = engine_stats.at(info.side == Side::Player1 ? e->engine1_id : e->engine2_id);
+        engine.wall_ms_total += info.wall.count();
+        engine.cpu_ms_total += info.cpu.value_or(info.wall).count();
+
+        if (info.search.depth == 0) {
+            continue;
+        }
+
+        engine.searches++;
+        engine.depth_total += info.search.depth;
+        engine.nps_total += info.search.nps;
+    }
+
     if (settings.verbose) {
         std::scoped_lock<std::mutex> lock(print_mutex);
         std::cout << termcolor::blue;
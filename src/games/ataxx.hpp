@@ -1,12 +1,16 @@
 #ifndef CUTEGAMES_GAMES_ATAXX_HPP
 #define CUTEGAMES_GAMES_ATAXX_HPP
 
+#include <algorithm>
 #include <libataxx/position.hpp>
+#include <optional>
+#include <stdexcept>
+#include <vector>
 #include "game.hpp"
 
 class [[nodiscard]] AtaxxGame final : public Game {
    public:
-    [[nodiscard]] explicit AtaxxGame(const std::string &fen) : Game(fen) {
+    [[nodiscard]] explicit AtaxxGame(const std::string &fen) : Game(fen, MoveEncoding::Ataxx) {
         m_pos.set_fen(fen);
         m_turn = m_pos.get_turn() == libataxx::Side::Black ? Side::Player1 : Side::Player2;
         m_first_mover = m_turn;
@@ -15,9 +19,13 @@ class [[nodiscard]] AtaxxGame final : public Game {
     ~AtaxxGame() override = default;
 
     void makemove(const std::string &movestr) override {
-        m_move_history.emplace_back(movestr);
-        const auto move = libataxx::Move::from_uai(movestr);
-        m_pos.makemove(move);
+        const auto move = find_legal_move(movestr);
+        if (!move) {
+            throw std::invalid_argument("Illegal move " + movestr);
+        }
+        m_position.push_back(movestr);
+        m_pos.makemove(*move);
+        m_legal_moves.reset();
     }
 
     [[nodiscard]] auto is_p1_turn(std::shared_ptr<Engine>) const -> bool override {
@@ -28,8 +36,9 @@ class [[nodiscard]] AtaxxGame final : public Game {
         return m_pos.is_gameover();
     }
 
-    [[nodiscard]] auto is_legal_move(const std::string &, std::shared_ptr<Engine>) const noexcept -> bool override {
-        return true;
+    [[nodiscard]] auto is_legal_move(const std::string &movestr, std::shared_ptr<Engine>) const noexcept
+        -> bool override {
+        return find_legal_move(movestr).has_value();
     }
 
     [[nodiscard]] auto get_result(std::shared_ptr<Engine>) const noexcept -> std::string override {
@@ -46,7 +55,26 @@ class [[nodiscard]] AtaxxGame final : public Game {
     }
 
    private:
+    // Anything the parser rejects or that isn't in the legal move list is illegal
+    [[nodiscard]] auto find_legal_move(const std::string &movestr) const noexcept -> std::optional<libataxx::Move> {
+        try {
+            // Generated once per position no matter how often the move is checked
+            if (!m_legal_moves) {
+                const auto moves = m_pos.legal_moves();
+                m_legal_moves.emplace(moves.begin(), moves.end());
+            }
+            const auto move = libataxx::Move::from_uai(movestr);
+            if (std::find(m_legal_moves->begin(), m_legal_moves->end(), move) == m_legal_moves->end()) {
+                return std::nullopt;
+            }
+            return move;
+        } catch (...) {
+            return std::nullopt;
+        }
+    }
+
     libataxx::Position m_pos;
+    mutable std::optional<std::vector<libataxx::Move>> m_legal_moves;
 };
 
 #endif
@@ -0,0 +1,186 @@
+#ifndef CUTEGAMES_GAMES_CONNECT4_HPP
+#define CUTEGAMES_GAMES_CONNECT4_HPP
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "game.hpp"
+
+// Connect Four on the standard 7x6 board, played by UGI engines
+//
+// Moves are the column letter "a" to "g", or the square the piece lands on such as "d1"
+// Either way the history, and so the engines, only ever see the column letter
+// The FEN lists the rows from the top down using x and o for the pieces and digits for runs of empty squares,
+// followed by the side to move, x moves first from the start position
+//   startpos = "7/7/7/7/7/7 x"
+//
+// Each player's pieces are a bitboard with a column every 7 bits, the 7th bit of each column always stays empty
+// so that shifting a line of four along any direction can't wrap around into the next column
+class [[nodiscard]] ConnectFourGame final : public Game {
+   public:
+    static constexpr int num_files = 7;
+    static constexpr int num_ranks = 6;
+
+    [[nodiscard]] explicit ConnectFourGame(const std::string &fen) : Game(fen) {
+        set_fen(fen == "startpos" || fen.empty() ? "7/7/7/7/7/7 x" : fen);
+        m_turn = m_p1_turn ? Side::Player1 : Side::Player2;
+        m_first_mover = m_turn;
+    }
+
+    ~ConnectFourGame() override = default;
+
+    void makemove(const std::string &movestr) override {
+        const auto file = parse_move(movestr);
+        if (!file) {
+            throw std::invalid_argument("Illegal move " + movestr);
+        }
+        m_position.push_back(column(*file));
+
+        const auto bit = std::uint64_t(1) << (7 * *file + m_heights[*file]);
+        m_pieces[m_p1_turn ? 0 : 1] |= bit;
+        m_heights[*file]++;
+        m_p1_turn = !m_p1_turn;
+        m_turn = m_p1_turn ? Side::Player1 : Side::Player2;
+    }
+
+    // Squares become the column they're in, throws if the move isn't legal here
+    [[nodiscard]] auto canonical_move(const std::string &movestr) const -> std::string override {
+        const auto file = parse_move(movestr);
+        if (!file) {
+            throw std::invalid_argument("Illegal move " + movestr);
+        }
+        return column(*file);
+    }
+
+    [[nodiscard]] auto is_p1_turn(std::shared_ptr<Engine>) const -> bool override {
+        return m_p1_turn;
+    }
+
+    [[nodiscard]] bool is_gameover(std::shared_ptr<Engine>) const noexcept override {
+        return is_win(m_pieces[0]) || is_win(m_pieces[1]) || is_full();
+    }
+
+    [[nodiscard]] auto is_legal_move(const std::string &movestr, std::shared_ptr<Engine>) const noexcept
+        -> bool override {
+        return parse_move(movestr).has_value();
+    }
+
+    [[nodiscard]] auto get_result(std::shared_ptr<Engine>) const noexcept -> std::string override {
+        if (is_win(m_pieces[0])) {
+            return "p1win";
+        } else if (is_win(m_pieces[1])) {
+            return "p2win";
+        } else if (is_full()) {
+            return "draw";
+        } else {
+            return "none";
+        }
+    }
+
+    // Every column with space left, empty once the game is over
+    [[nodiscard]] auto legal_moves() const -> std::vector<std::string> {
+        auto moves = std::vector<std::string>();
+        if (is_gameover(nullptr)) {
+            return moves;
+        }
+        for (int file = 0; file < num_files; ++file) {
+            if (m_heights[file] < num_ranks) {
+                moves.emplace_back(column(file));
+            }
+        }
+        return moves;
+    }
+
+   private:
+    [[nodiscard]] static auto column(const int file) -> std::string {
+        return std::string(1, static_cast<char>('a' + file));
+    }
+
+    // Four in a row vertically, horizontally, and along both diagonals
+    [[nodiscard]] static constexpr auto is_win(const std::uint64_t bb) noexcept -> bool {
+        for (const auto shift : {1, 7, 6, 8}) {
+            const auto pairs = bb & (bb >> shift);
+            if (pairs & (pairs >> (2 * shift))) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    [[nodiscard]] auto is_full() const noexcept -> bool {
+        return std::popcount(m_pieces[0] | m_pieces[1]) == num_files * num_ranks;
+    }
+
+    // The column the move is played in, if it's legal
+    [[nodiscard]] auto parse_move(const std::string &movestr) const noexcept -> std::optional<int> {
+        if (movestr.empty() || movestr.size() > 2 || is_gameover(nullptr)) {
+            return std::nullopt;
+        }
+
+        const auto file = movestr[0] - 'a';
+        if (file < 0 || file >= num_files || m_heights[file] >= num_ranks) {
+            return std::nullopt;
+        }
+
+        // The square has to be the one the piece drops to
+        if (movestr.size() == 2 && movestr[1] - '1' != m_heights[file]) {
+            return std::nullopt;
+        }
+
+        return file;
+    }
+
+    auto set_fen(const std::string &fen) -> void {
+        auto rank = num_ranks - 1;
+        auto file = 0;
+        auto i = std::size_t(0);
+
+        for (; i < fen.size() && fen[i] != ' '; ++i) {
+            const auto c = fen[i];
+            if (c == '/') {
+                if (file != num_files || rank == 0) {
+                    throw std::invalid_argument("Invalid Connect Four FEN");
+                }
+                rank--;
+                file = 0;
+            } else if ('1' <= c && c <= '7') {
+                file += c - '0';
+            } else if ((c == 'x' || c == 'o') && file < num_files) {
+                m_pieces[c == 'x' ? 0 : 1] |= std::uint64_t(1) << (7 * file + rank);
+                file++;
+            } else {
+                throw std::invalid_argument("Invalid Connect Four FEN");
+            }
+
+            if (file > num_files) {
+                throw std::invalid_argument("Invalid Connect Four FEN");
+            }
+        }
+
+        if (file != num_files || rank != 0 || i + 2 != fen.size() || (fen[i + 1] != 'x' && fen[i + 1] != 'o')) {
+            throw std::invalid_argument("Invalid Connect Four FEN");
+        }
+        m_p1_turn = fen[i + 1] == 'x';
+
+        // Pieces can't float, so each column has to be filled from the bottom without gaps
+        const auto occupied = m_pieces[0] | m_pieces[1];
+        for (int f = 0; f < num_files; ++f) {
+            const auto column = (occupied >> (7 * f)) & 0x7F;
+            m_heights[f] = std::popcount(column);
+            if (column != (std::uint64_t(1) << m_heights[f]) - 1) {
+                throw std::invalid_argument("Invalid Connect Four FEN");
+            }
+        }
+    }
+
+    // Player 1 then player 2
+    std::array<std::uint64_t, 2> m_pieces = {};
+    std::array<int, num_files> m_heights = {};
+    bool m_p1_turn = true;
+};
+
+#endif
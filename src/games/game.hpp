@@ -1,17 +1,22 @@
 #ifndef GAME_HPP
 #define GAME_HPP
 
+#include <chrono>
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
 #include "../engine/engine.hpp"
+#include "game_position.hpp"
+#include "move_history.hpp"
 
 enum class [[nodiscard]] GameType
 {
     Generic = 0,
     Ataxx,
     Chess,
+    ConnectFour,
 };
 
 enum class [[nodiscard]] GameResult
@@ -35,6 +40,7 @@ enum class [[nodiscard]] AdjudicationReason
     Crash,
     IllegalMove,
     Gamelength,
+    Draw,
     GameoverMismatch,
     ResultMismatch,
     None,
@@ -47,22 +53,39 @@ enum class [[nodiscard]] AdjudicationReason
 static_assert(Side::Player1 == !Side::Player2);
 static_assert(Side::Player2 == !Side::Player1);
 
+struct [[nodiscard]] MoveInfo {
+    Side side = Side::Player1;
+    SearchInfo search;
+    std::chrono::milliseconds wall = std::chrono::milliseconds(0);
+    // Only set if the engine's CPU time could be measured
+    std::optional<std::chrono::milliseconds> cpu;
+};
+
 class Game {
    public:
-    [[nodiscard]] Game() : m_start_fen("startpos") {
-    }
+    [[nodiscard]] Game() = default;
 
-    [[nodiscard]] explicit Game(std::string fen) : m_start_fen(std::move(fen)) {
+    [[nodiscard]] explicit Game(std::string fen, const MoveEncoding encoding = MoveEncoding::Text)
+        : m_position(std::move(fen), encoding) {
     }
 
     virtual ~Game() = default;
 
-    [[nodiscard]] auto move_history() const noexcept -> const std::vector<std::string> & {
-        return m_move_history;
+    [[nodiscard]] auto move_history() const noexcept -> const MoveHistory & {
+        return m_position.moves();
+    }
+
+    // What the engines are sent to set up the current position
+    [[nodiscard]] auto position() const noexcept -> const GamePosition & {
+        return m_position;
+    }
+
+    [[nodiscard]] auto move_info() const noexcept -> const std::vector<MoveInfo> & {
+        return m_move_info;
     }
 
     [[nodiscard]] auto start_fen() const noexcept -> const std::string & {
-        return m_start_fen;
+        return m_position.start_fen();
     }
 
     [[nodiscard]] virtual auto turn() const noexcept -> Side {
@@ -84,6 +107,18 @@ class Game {
 
     virtual auto makemove(const std::string &movestr) -> void = 0;
 
+    // The move as the history would store it, so that different spellings of the same move compare equal
+    // Throws if the move can't be stored
+    [[nodiscard]] virtual auto canonical_move(const std::string &movestr) const -> std::string {
+        auto history = MoveHistory(move_history().encoding());
+        history.push_back(movestr);
+        return std::string(history.back());
+    }
+
+    auto add_move_info(const MoveInfo &info) -> void {
+        m_move_info.emplace_back(info);
+    }
+
     auto set_turn(const Side side) noexcept -> void {
         m_turn = side;
     }
@@ -93,8 +128,8 @@ class Game {
     }
 
    protected:
-    std::string m_start_fen;
-    std::vector<std::string> m_move_history;
+    GamePosition m_position;
+    std::vector<MoveInfo> m_move_info;
     Side m_turn = Side::Player1;
     Side m_first_mover = Side::Player1;
 };
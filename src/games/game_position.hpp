@@ -0,0 +1,85 @@
+#ifndef CUTEGAMES_GAMES_GAME_POSITION_HPP
+#define CUTEGAMES_GAMES_GAME_POSITION_HPP
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <utility>
+#include "move_history.hpp"
+
+// The start position and moves of a game, along with the "position ..." command that describes them
+// The command grows by one token per move and is cut back when the moves are cleared, so it's never rebuilt
+class [[nodiscard]] GamePosition {
+   public:
+    [[nodiscard]] GamePosition() : GamePosition("startpos") {
+    }
+
+    [[nodiscard]] explicit GamePosition(std::string start_fen, const MoveEncoding encoding = MoveEncoding::Text)
+        : m_start_fen(std::move(start_fen)), m_moves(encoding) {
+        if (m_start_fen.empty() || m_start_fen == "startpos") {
+            m_command = "position startpos";
+        } else {
+            m_command = "position fen " + m_start_fen;
+        }
+        m_moves_offset = m_command.size();
+    }
+
+    // Throws if the move can't be stored in the history
+    auto push_back(const std::string_view move) -> void {
+        m_moves.push_back(move);
+        if (m_moves.size() == 1) {
+            m_command += " moves";
+        }
+        // The history may have stored the move in its canonical form, so that's what the engines are sent
+        m_command += ' ';
+        m_command += m_moves.back();
+    }
+
+    // Back to the start position
+    auto clear() noexcept -> void {
+        m_moves.clear();
+        m_command.resize(m_moves_offset);
+    }
+
+    [[nodiscard]] auto start_fen() const noexcept -> const std::string & {
+        return m_start_fen;
+    }
+
+    [[nodiscard]] auto moves() const noexcept -> const MoveHistory & {
+        return m_moves;
+    }
+
+    [[nodiscard]] auto command() const noexcept -> const std::string & {
+        return m_command;
+    }
+
+    // The moves this position adds to an earlier command from the same game, each preceded by a space
+    // Empty if the earlier command isn't a strict prefix of this one
+    [[nodiscard]] auto moves_after(const std::string_view earlier) const noexcept -> std::string_view {
+        const auto command = std::string_view(m_command);
+        if (earlier.size() < m_moves_offset || earlier.size() >= command.size() || !command.starts_with(earlier) ||
+            command[earlier.size()] != ' ') {
+            return {};
+        }
+
+        auto rest = command.substr(earlier.size());
+        // The earlier command had no moves at all
+        if (earlier.size() == m_moves_offset) {
+            rest.remove_prefix(std::string_view(" moves").size());
+        }
+        return rest;
+    }
+
+    [[nodiscard]] auto operator==(const GamePosition &rhs) const noexcept -> bool {
+        return m_command == rhs.m_command;
+    }
+
+   private:
+    std::string m_start_fen;
+    MoveHistory m_moves;
+    std::string m_command;
+    // Where the moves start in the command
+    std::size_t m_moves_offset = 0;
+};
+
+#endif
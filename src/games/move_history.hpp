@@ -0,0 +1,250 @@
+#ifndef CUTEGAMES_GAMES_MOVE_HISTORY_HPP
+#define CUTEGAMES_GAMES_MOVE_HISTORY_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+// How moves are packed into a MoveHistory
+enum class [[nodiscard]] MoveEncoding : std::uint8_t
+{
+    // A length byte followed by the move as it was sent
+    Text = 0,
+    // Two bytes, from and to squares, a single move has them equal
+    Ataxx,
+    // Two bytes, from and to squares and the promotion piece
+    Chess,
+};
+
+// Every move of a game packed into one buffer instead of a string each
+// Ataxx and Chess moves are stored in a canonical lowercase form, other games keep exactly what they're given
+//
+// Moves are read as string views rather than strings, so the same rules apply as to iterators over a std::vector:
+// - push_back and clear invalidate every iterator, and every move read through one
+// - A move read from an iterator may also point into the iterator itself, so it's only valid until that iterator
+//   is dereferenced again or destroyed
+// Copy a move into a std::string to keep it for any longer
+class [[nodiscard]] MoveHistory {
+   public:
+    static constexpr std::size_t max_text_length = 255;
+
+    class [[nodiscard]] const_iterator {
+       public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::string_view;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = std::string_view;
+
+        [[nodiscard]] const_iterator() = default;
+
+        // Text moves point into the history and decoded ones into the iterator, see the rules above
+        [[nodiscard]] auto operator*() const -> std::string_view {
+            if (m_history->m_encoding == MoveEncoding::Text) {
+                const auto length = static_cast<std::uint8_t>(m_history->m_data[m_offset]);
+                return std::string_view(m_history->m_data).substr(m_offset + 1, length);
+            }
+            return decode(m_history->m_encoding, packed(), m_buffer);
+        }
+
+        auto operator++() -> const_iterator & {
+            m_offset += m_history->entry_size(m_offset);
+            return *this;
+        }
+
+        auto operator++(int) -> const_iterator {
+            auto copy = *this;
+            ++*this;
+            return copy;
+        }
+
+        [[nodiscard]] auto operator==(const const_iterator &rhs) const noexcept -> bool {
+            return m_offset == rhs.m_offset;
+        }
+
+       private:
+        friend class MoveHistory;
+
+        [[nodiscard]] const_iterator(const MoveHistory *history, const std::size_t offset)
+            : m_history(history), m_offset(offset) {
+        }
+
+        [[nodiscard]] auto packed() const noexcept -> std::uint16_t {
+            return static_cast<std::uint16_t>(static_cast<std::uint8_t>(m_history->m_data[m_offset]) |
+                                              static_cast<std::uint8_t>(m_history->m_data[m_offset + 1]) << 8);
+        }
+
+        const MoveHistory *m_history = nullptr;
+        std::size_t m_offset = 0;
+        mutable std::array<char, 8> m_buffer = {};
+    };
+
+    [[nodiscard]] MoveHistory() = default;
+
+    [[nodiscard]] explicit MoveHistory(const MoveEncoding encoding) : m_encoding(encoding) {
+    }
+
+    [[nodiscard]] MoveHistory(const MoveEncoding encoding, const std::initializer_list<std::string_view> moves)
+        : m_encoding(encoding) {
+        for (const auto move : moves) {
+            push_back(move);
+        }
+    }
+
+    // Throws if the move can't be represented in this encoding
+    auto push_back(const std::string_view move) -> void {
+        const auto offset = m_data.size();
+        if (m_encoding == MoveEncoding::Text) {
+            if (move.size() > max_text_length) {
+                throw std::invalid_argument("Move too long");
+            }
+            m_data.push_back(static_cast<char>(move.size()));
+            m_data.append(move);
+        } else {
+            const auto packed = encode(m_encoding, move);
+            m_data.push_back(static_cast<char>(packed & 0xFF));
+            m_data.push_back(static_cast<char>(packed >> 8));
+            // Kept decoded so that back() has somewhere to point
+            m_back_length = decode(m_encoding, packed, m_back_buffer).size();
+        }
+        m_back = offset;
+        m_size++;
+    }
+
+    auto clear() noexcept -> void {
+        m_data.clear();
+        m_back = 0;
+        m_back_length = 0;
+        m_size = 0;
+    }
+
+    [[nodiscard]] auto begin() const noexcept -> const_iterator {
+        return const_iterator(this, 0);
+    }
+
+    [[nodiscard]] auto end() const noexcept -> const_iterator {
+        return const_iterator(this, m_data.size());
+    }
+
+    // The history mustn't be empty, the move is invalidated by push_back and clear like the ones read from iterators
+    [[nodiscard]] auto back() const -> std::string_view {
+        if (m_encoding == MoveEncoding::Text) {
+            return *const_iterator(this, m_back);
+        }
+        return std::string_view(m_back_buffer.data(), m_back_length);
+    }
+
+    [[nodiscard]] auto size() const noexcept -> std::size_t {
+        return m_size;
+    }
+
+    [[nodiscard]] auto empty() const noexcept -> bool {
+        return m_size == 0;
+    }
+
+    [[nodiscard]] auto encoding() const noexcept -> MoveEncoding {
+        return m_encoding;
+    }
+
+    // Is this history the other one followed by zero or more moves
+    [[nodiscard]] auto starts_with(const MoveHistory &other) const noexcept -> bool {
+        return m_encoding == other.m_encoding && std::string_view(m_data).starts_with(other.m_data);
+    }
+
+    [[nodiscard]] auto operator==(const MoveHistory &rhs) const noexcept -> bool {
+        return m_encoding == rhs.m_encoding && m_data == rhs.m_data;
+    }
+
+   private:
+    [[nodiscard]] auto entry_size(const std::size_t offset) const noexcept -> std::size_t {
+        if (m_encoding == MoveEncoding::Text) {
+            return 1 + static_cast<std::uint8_t>(m_data[offset]);
+        }
+        return 2;
+    }
+
+    static constexpr std::uint16_t null_move = 0xFFFF;
+
+    [[nodiscard]] static auto square(const char file, const char rank) -> std::uint16_t {
+        const auto f = file | 0x20;
+        if (f < 'a' || f > 'h' || rank < '1' || rank > '8') {
+            throw std::invalid_argument("Can't encode move");
+        }
+        return static_cast<std::uint16_t>(8 * (rank - '1') + (f - 'a'));
+    }
+
+    [[nodiscard]] static auto encode(const MoveEncoding encoding, const std::string_view move) -> std::uint16_t {
+        if (move == "0000") {
+            return null_move;
+        }
+
+        if (encoding == MoveEncoding::Ataxx && move.size() == 2) {
+            const auto to = square(move[0], move[1]);
+            return static_cast<std::uint16_t>(to | to << 6);
+        } else if (encoding == MoveEncoding::Ataxx && move.size() == 4) {
+            const auto from = square(move[0], move[1]);
+            const auto to = square(move[2], move[3]);
+            if (from == to) {
+                throw std::invalid_argument("Can't encode move");
+            }
+            return static_cast<std::uint16_t>(from | to << 6);
+        } else if (encoding == MoveEncoding::Chess && (move.size() == 4 || move.size() == 5)) {
+            const auto from = square(move[0], move[1]);
+            const auto to = square(move[2], move[3]);
+            auto promo = 0;
+            if (move.size() == 5) {
+                promo = static_cast<int>(std::string_view(promotions).find(static_cast<char>(move[4] | 0x20)));
+                if (promo <= 0) {
+                    throw std::invalid_argument("Can't encode move");
+                }
+            }
+            return static_cast<std::uint16_t>(from | to << 6 | promo << 12);
+        }
+
+        throw std::invalid_argument("Can't encode move");
+    }
+
+    [[nodiscard]] static auto decode(const MoveEncoding encoding,
+                                     const std::uint16_t packed,
+                                     std::array<char, 8> &buffer) -> std::string_view {
+        if (packed == null_move) {
+            return "0000";
+        }
+
+        const auto from = packed & 0x3F;
+        const auto to = (packed >> 6) & 0x3F;
+        const auto promo = packed >> 12;
+        auto length = std::size_t(0);
+
+        if (encoding == MoveEncoding::Chess || from != to) {
+            buffer[length++] = static_cast<char>('a' + from % 8);
+            buffer[length++] = static_cast<char>('1' + from / 8);
+        }
+        buffer[length++] = static_cast<char>('a' + to % 8);
+        buffer[length++] = static_cast<char>('1' + to / 8);
+        if (promo) {
+            buffer[length++] = promotions[promo];
+        }
+
+        return std::string_view(buffer.data(), length);
+    }
+
+    // Indexed by the promotion bits, 0 is no promotion
+    static constexpr char promotions[] = " nbrq";
+
+    MoveEncoding m_encoding = MoveEncoding::Text;
+    std::string m_data;
+    // Where the last move starts in the buffer
+    std::size_t m_back = 0;
+    // The last move decoded, only used by the packed encodings
+    std::array<char, 8> m_back_buffer = {};
+    std::size_t m_back_length = 0;
+    std::size_t m_size = 0;
+};
+
+#endif
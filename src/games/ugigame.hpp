@@ -5,34 +5,41 @@
 
 class [[nodiscard]] UGIGame final : public Game {
    public:
-    [[nodiscard]] explicit UGIGame(const std::string &fen) : Game(fen) {
+    // The engines are marked as timed out if they don't answer a query within the timeout
+    [[nodiscard]] explicit UGIGame(const std::string &fen, const Engine::timeout_type reply_timeout = {})
+        : Game(fen), m_reply_timeout(reply_timeout) {
     }
 
     ~UGIGame() override = default;
 
     void makemove(const std::string &movestr) override {
-        m_move_history.emplace_back(movestr);
+        m_position.push_back(movestr);
         m_turn = !m_turn;
     }
 
     [[nodiscard]] auto is_p1_turn(std::shared_ptr<Engine> engine) const -> bool override {
-        engine->position(start_fen(), move_history());
-        return engine->query_p1turn();
+        engine->position(m_position);
+        return engine->query_p1turn(m_reply_timeout);
     }
 
     [[nodiscard]] bool is_gameover(std::shared_ptr<Engine> engine) const noexcept override {
-        engine->position(start_fen(), move_history());
-        return engine->query_gameover();
+        engine->position(m_position);
+        return engine->query_gameover(m_reply_timeout);
     }
 
-    [[nodiscard]] auto is_legal_move(const std::string &, std::shared_ptr<Engine>) const noexcept -> bool override {
-        return true;
+    // Only the engines know the rules, but the move has to fit in the history
+    [[nodiscard]] auto is_legal_move(const std::string &movestr, std::shared_ptr<Engine>) const noexcept
+        -> bool override {
+        return movestr.size() <= MoveHistory::max_text_length;
     }
 
     [[nodiscard]] auto get_result(std::shared_ptr<Engine> engine) const noexcept -> std::string override {
-        engine->position(start_fen(), move_history());
-        return engine->query_result();
+        engine->position(m_position);
+        return engine->query_result(m_reply_timeout);
     }
+
+   private:
+    Engine::timeout_type m_reply_timeout;
 };
 
 #endif
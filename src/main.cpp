@@ -1,10 +1,12 @@
 #include <CLI/CLI.hpp>
 #include <chrono>
 #include <csignal>
+#include <deque>
 #include <iostream>
 #include <memory>
 #include <stdexcept>
 #include <string>
+#include <unordered_set>
 #include <vector>
 // Games
 #include "games/game.hpp"
@@ -21,31 +23,40 @@
 #include "tournament/generator.hpp"
 #include "tournament/roundrobin.hpp"
 // Engines
+#include "engine/affinity.hpp"
+#include "engine/engine_plugin.hpp"
 #include "engine/engine_uai.hpp"
 #include "engine/engine_uci.hpp"
 #include "engine/engine_ugi.hpp"
+#include "engine/stderr_log.hpp"
+#include "engine/watchdog.hpp"
 // Stuff
 #include "cutegames.hpp"
+#include "spawner.hpp"
 #include "store.hpp"
 #include "tournament/types.hpp"
 
 [[nodiscard]] auto make_engine(const GameType game_type,
                                const EngineSettings &settings,
-                               const bool debug = false) -> std::shared_ptr<Engine> {
-    auto make_engine = [&game_type, &settings]() -> std::shared_ptr<Engine> {
+                               const bool debug = false,
+                               const Engine::timeout_type reply_timeout = {},
+                               StderrLog *stderr_log = nullptr,
+                               Watchdog *watchdog = nullptr) -> std::shared_ptr<Engine> {
+    auto make_engine = [&game_type, &settings, stderr_log]() -> std::shared_ptr<ProcessEngine> {
         switch (game_type) {
             case GameType::Generic:
-                return std::make_shared<UGIEngine>(settings.id, settings.path, settings.parameters);
+            case GameType::ConnectFour:
+                return std::make_shared<UGIEngine>(settings.id, settings.path, settings.parameters, stderr_log);
             case GameType::Ataxx:
-                return std::make_shared<UAIEngine>(settings.id, settings.path, settings.parameters);
+                return std::make_shared<UAIEngine>(settings.id, settings.path, settings.parameters, stderr_log);
             case GameType::Chess:
-                return std::make_shared<UCIEngine>(settings.id, settings.path, settings.parameters);
+                return std::make_shared<UCIEngine>(settings.id, settings.path, settings.parameters, stderr_log);
             default:
                 throw std::invalid_argument("Unrecognised game type");
         }
     };
 
-    auto make_engine_debug = [&game_type, &settings]() -> std::shared_ptr<Engine> {
+    auto make_engine_debug = [&game_type, &settings, stderr_log]() -> std::shared_ptr<ProcessEngine> {
         const auto debug_recv = [](const std::string_view &msg) {
             std::cout << "<recv:" << std::this_thread::get_id() << "> " << msg << "\n";
         };
@@ -56,29 +67,61 @@
 
         switch (game_type) {
             case GameType::Generic:
+            case GameType::ConnectFour:
                 return std::make_shared<UGIEngine>(
-                    settings.id, settings.path, settings.parameters, debug_recv, debug_send);
+                    settings.id, settings.path, settings.parameters, debug_recv, debug_send, stderr_log);
             case GameType::Ataxx:
                 return std::make_shared<UAIEngine>(
-                    settings.id, settings.path, settings.parameters, debug_recv, debug_send);
+                    settings.id, settings.path, settings.parameters, debug_recv, debug_send, stderr_log);
             case GameType::Chess:
                 return std::make_shared<UCIEngine>(
-                    settings.id, settings.path, settings.parameters, debug_recv, debug_send);
+                    settings.id, settings.path, settings.parameters, debug_recv, debug_send, stderr_log);
             default:
                 throw std::invalid_argument("Unrecognised game type");
         }
     };
 
-    auto engine = debug ? make_engine_debug() : make_engine();
+    using clock_type = std::chrono::steady_clock;
+    const auto t0 = clock_type::now();
 
-    engine->init();
+    auto engine = std::shared_ptr<Engine>();
+
+    if (settings.protocol == EngineProtocol::Plugin) {
+        engine = std::make_shared<PluginEngine>(settings.id, settings.path);
+    } else {
+        auto process = debug ? make_engine_debug() : make_engine();
+
+        if (watchdog) {
+            process->watch(*watchdog);
+        }
+
+        engine = process;
+    }
+
+    const auto t1 = clock_type::now();
+
+    engine->init(reply_timeout);
+
+    if (engine->timed_out()) {
+        throw std::runtime_error("Failed to start " + settings.path + ": no reply to the handshake");
+    }
+
+    const auto t2 = clock_type::now();
 
     // Set options
     for (const auto &[name, value] : settings.options) {
         engine->set_option(name, value);
     }
 
-    engine->is_ready();
+    engine->is_ready(reply_timeout);
+
+    const auto t3 = clock_type::now();
+
+    engine->set_startup_times(StartupTimes{
+        .spawn = std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0),
+        .init = std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1),
+        .ready = std::chrono::duration_cast<std::chrono::microseconds>(t3 - t2),
+    });
 
     return engine;
 }
@@ -98,6 +141,9 @@ auto print_engine_settings(const std::vector<EngineSettings> &engine_settings) n
             case EngineProtocol::UCI:
                 std::cout << " UCI";
                 break;
+            case EngineProtocol::Plugin:
+                std::cout << " Plugin";
+                break;
         }
         std::cout << " " << data.path;
         std::cout << " " << data.parameters;
@@ -108,14 +154,65 @@ auto print_engine_settings(const std::vector<EngineSettings> &engine_settings) n
     }
 }
 
+[[nodiscard]] auto engine_names(const std::vector<EngineSettings> &engine_settings) -> std::vector<std::string> {
+    auto names = std::vector<std::string>();
+    for (const auto &engine : engine_settings) {
+        names.emplace_back(engine.name);
+    }
+    return names;
+}
+
 auto print_statistics(const MatchStatistics &stats) noexcept -> void {
     std::cout << "Statistics:\n";
     std::cout << "Engines loaded: " << stats.num_engine_loads << "\n";
     std::cout << "Engines unloaded: " << stats.num_engine_unloads << "\n";
+    std::cout << "Engine startup: spawn " << stats.engine_startup.spawn.count() / 1000 << "ms";
+    std::cout << " init " << stats.engine_startup.init.count() / 1000 << "ms";
+    std::cout << " ready " << stats.engine_startup.ready.count() / 1000 << "ms\n";
     std::cout << "Games finished: " << stats.num_games_finished << "\n";
     std::cout << "Player 1 Score: +" << stats.num_p1_wins << "-" << stats.num_p2_wins << "=" << stats.num_draws << "\n";
 }
 
+auto print_search_statistics(const std::vector<EngineSettings> &engine_settings,
+                             const std::vector<EngineStatistics> &engine_stats) noexcept -> void {
+    std::cout << "Search statistics:\n";
+    for (std::size_t i = 0; i < engine_settings.size(); ++i) {
+        const auto &stats = engine_stats[i];
+        std::cout << "- " << engine_settings[i].name;
+        if (stats.searches > 0) {
+            std::cout << " depth " << static_cast<float>(stats.depth_total) / stats.searches;
+            std::cout << " nps " << stats.nps_total / stats.searches;
+        }
+        std::cout << " searches " << stats.searches;
+        std::cout << " flagged " << stats.flagged;
+        std::cout << " illegal " << stats.illegal;
+        std::cout << " wall " << stats.wall_ms_total << "ms";
+        std::cout << " cpu " << stats.cpu_ms_total << "ms";
+        std::cout << "\n";
+    }
+}
+
+auto print_latency_statistics(const std::vector<EngineSettings> &engine_settings,
+                              const std::vector<EngineStatistics> &engine_stats) noexcept -> void {
+    std::cout << "Latency statistics:\n";
+    for (std::size_t i = 0; i < engine_settings.size(); ++i) {
+        std::cout << "- " << engine_settings[i].name << "\n";
+        for (std::size_t j = 0; j < num_latency_types; ++j) {
+            const auto &histogram = engine_stats[i].latency[j];
+            if (histogram.count() == 0) {
+                continue;
+            }
+            std::cout << "  " << latency_name(static_cast<LatencyType>(j));
+            std::cout << " n " << histogram.count();
+            std::cout << " p50 " << histogram.percentile(50.0).count() << "us";
+            std::cout << " p90 " << histogram.percentile(90.0).count() << "us";
+            std::cout << " p99 " << histogram.percentile(99.0).count() << "us";
+            std::cout << " max " << histogram.max().count() << "us";
+            std::cout << "\n";
+        }
+    }
+}
+
 auto print_about() noexcept -> void {
     std::cout << "Cute Games v" << version_major << "." << version_minor;
 #ifndef NDEBUG
@@ -187,6 +284,9 @@ auto main(const int argc, const char *const *const argv) noexcept -> int {
         settings.verbose = *override_verbose;
     }
 
+    // Engines that die while we're writing to them are handled as crashes
+    std::signal(SIGPIPE, SIG_IGN);
+
     // Disable buffering for stdin & stdout
     std::setbuf(stdin, nullptr);
     std::setbuf(stdout, nullptr);
@@ -220,6 +320,12 @@ auto main(const int argc, const char *const *const argv) noexcept -> int {
     dispatcher.register_event_listener(EventID::zEngineLoaded, [&settings, &stats](const auto &event) {
         on_engine_loaded(event, settings, stats);
     });
+    dispatcher.register_event_listener(EventID::zEngineCrashed, [&settings, &engine_statistics](const auto &event) {
+        on_engine_crashed(event, settings, engine_statistics);
+    });
+    dispatcher.register_event_listener(EventID::zEngineLatency, [&engine_statistics](const auto &event) {
+        on_engine_latency(event, engine_statistics);
+    });
     dispatcher.register_event_listener(EventID::zEngineUnloaded, [&settings, &stats](const auto &event) {
         on_engine_unloaded(event, settings, stats);
     });
@@ -230,8 +336,37 @@ auto main(const int argc, const char *const *const argv) noexcept -> int {
     const auto t0 = std::chrono::steady_clock::now();
 
     auto engine_data = std::vector<EngineStatistics>(settings.engine_settings.size());
+    auto stderr_log = settings.stderr_log.enabled ? std::make_unique<StderrLog>(settings.stderr_log.directory,
+                                                                                engine_names(settings.engine_settings),
+                                                                                settings.stderr_log.max_bytes,
+                                                                                settings.stderr_log.num_backups)
+                                                  : nullptr;
+    const auto reply_timeout = settings.adjudication.replytimeout > 0
+                                   ? Engine::timeout_type(std::chrono::milliseconds(settings.adjudication.replytimeout))
+                                   : std::nullopt;
+    auto watchdog = settings.watchdog.enabled
+                        ? std::make_unique<Watchdog>(std::chrono::milliseconds(settings.watchdog.grace),
+                                                     std::chrono::milliseconds(settings.watchdog.hang_limit))
+                        : nullptr;
+    auto spawner = settings.num_prespawn > 0
+                       ? std::make_unique<Spawner<Engine>>(
+                             settings.engine_settings.size(),
+                             settings.num_prespawn,
+                             1,
+                             [&settings, &reply_timeout, &stderr_log, &watchdog](const std::size_t id) {
+                                 return make_engine(settings.game_type,
+                                                    settings.engine_settings[id],
+                                                    settings.debug,
+                                                    reply_timeout,
+                                                    stderr_log.get(),
+                                                    watchdog.get());
+                             })
+                       : nullptr;
     std::vector<std::thread> workers;
     std::mutex mtx;
+    // Games interrupted by a crash, to be played again
+    std::deque<GameInfo> requeued_games;
+    std::unordered_set<std::size_t> requeued_ids;
     auto generator = make_generator(settings.tournament_type,
                                     settings.engine_settings.size(),
                                     settings.num_games,
@@ -240,14 +375,37 @@ auto main(const int argc, const char *const *const argv) noexcept -> int {
 
     stats.num_games_total = generator->expected();
 
+    // Each worker gets its own CPUs to run its engines on
+    const auto cpu_slots =
+        settings.affinity.enabled
+            ? make_cpu_slots(read_cpu_topology(), settings.num_threads, settings.affinity.smt, settings.affinity.numa)
+            : std::vector<CpuSet>();
+
+    if (!cpu_slots.empty()) {
+        std::cout << "CPU affinity:\n";
+        for (std::size_t i = 0; i < cpu_slots.size(); ++i) {
+            std::cout << "- worker " << i << " cpus";
+            for (const auto cpu : cpu_slots[i]) {
+                std::cout << " " << cpu;
+            }
+            std::cout << "\n";
+        }
+        std::cout << "\n";
+    }
+
     for (std::size_t i = 0; i < settings.num_threads; ++i) {
-        workers.emplace_back([&]() {
+        workers.emplace_back([&, i]() {
             auto engine_store = Store<Engine>(settings.engine_store_size);
 
             while (!quit) {
                 // Get work
-                const auto info = [&generator, &mtx]() -> std::optional<GameInfo> {
+                const auto info = [&generator, &mtx, &requeued_games]() -> std::optional<GameInfo> {
                     std::scoped_lock lock(mtx);
+                    if (!requeued_games.empty()) {
+                        const auto game = requeued_games.front();
+                        requeued_games.pop_front();
+                        return game;
+                    }
                     if (generator->is_finished()) {
                         return {};
                     }
@@ -272,22 +430,61 @@ auto main(const int argc, const char *const *const argv) noexcept -> int {
                     return id == obj->get_id();
                 });
 
+                // Try get engines that were started in the background
+                if (!engine1 && spawner) {
+                    engine1 = spawner->get(info->idx_player1);
+                    if (engine1) {
+                        dispatcher.post_event(
+                            std::make_shared<EngineCreated>(info->idx_player1,
+                                                            settings.engine_settings[info->idx_player1].name,
+                                                            settings.engine_settings[info->idx_player1].path,
+                                                            (*engine1)->startup_times()));
+                    }
+                }
+                if (!engine2 && spawner) {
+                    engine2 = spawner->get(info->idx_player2);
+                    if (engine2) {
+                        dispatcher.post_event(
+                            std::make_shared<EngineCreated>(info->idx_player2,
+                                                            settings.engine_settings[info->idx_player2].name,
+                                                            settings.engine_settings[info->idx_player2].path,
+                                                            (*engine2)->startup_times()));
+                    }
+                }
+
                 // Create engine instance if not returned from store
                 if (!engine1) {
                     engine1 =
-                        make_engine(settings.game_type, settings.engine_settings[info->idx_player1], settings.debug);
+                        make_engine(settings.game_type,
+                                    settings.engine_settings[info->idx_player1],
+                                    settings.debug,
+                                    reply_timeout,
+                                    stderr_log.get(),
+                                    watchdog.get());
                     dispatcher.post_event(
                         std::make_shared<EngineCreated>(info->idx_player1,
                                                         settings.engine_settings[info->idx_player1].name,
-                                                        settings.engine_settings[info->idx_player1].path));
+                                                        settings.engine_settings[info->idx_player1].path,
+                                                        (*engine1)->startup_times()));
                 }
                 if (!engine2) {
                     engine2 =
-                        make_engine(settings.game_type, settings.engine_settings[info->idx_player2], settings.debug);
+                        make_engine(settings.game_type,
+                                    settings.engine_settings[info->idx_player2],
+                                    settings.debug,
+                                    reply_timeout,
+                                    stderr_log.get(),
+                                    watchdog.get());
                     dispatcher.post_event(
                         std::make_shared<EngineCreated>(info->idx_player2,
                                                         settings.engine_settings[info->idx_player2].name,
-                                                        settings.engine_settings[info->idx_player2].path));
+                                                        settings.engine_settings[info->idx_player2].path,
+                                                        (*engine2)->startup_times()));
+                }
+
+                if (i < cpu_slots.size()) {
+                    (*engine1)->set_affinity(cpu_slots[i]);
+                    (*engine2)->set_affinity(cpu_slots[i]);
                 }
 
                 dispatcher.post_event(std::make_shared<GameStarted>(
@@ -301,12 +498,40 @@ auto main(const int argc, const char *const *const argv) noexcept -> int {
                                           *engine1,
                                           *engine2);
 
-                dispatcher.post_event(std::make_shared<GameFinished>(
-                    info->id, (*engine1)->get_id(), (*engine2)->get_id(), gg.result, gg.reason, gg.game));
+                const auto crashed1 = (*engine1)->crashed();
+                const auto crashed2 = (*engine2)->crashed();
+
+                if (crashed1) {
+                    dispatcher.post_event(std::make_shared<EngineCrashed>(info->idx_player1));
+                }
+                if (crashed2) {
+                    dispatcher.post_event(std::make_shared<EngineCrashed>(info->idx_player2));
+                }
+
+                // Hand over the round trips timed during the game, including the engines' startup
+                dispatcher.post_event(std::make_shared<EngineLatency>(info->idx_player1, (*engine1)->take_latency()));
+                dispatcher.post_event(std::make_shared<EngineLatency>(info->idx_player2, (*engine2)->take_latency()));
+
+                // Play the game again with a new engine, but only once so a broken engine can't stall the match
+                const auto requeue = settings.recover && gg.reason == AdjudicationReason::Crash &&
+                                     [&info, &mtx, &requeued_games, &requeued_ids]() {
+                                         std::scoped_lock lock(mtx);
+                                         if (!requeued_ids.insert(info->id).second) {
+                                             return false;
+                                         }
+                                         requeued_games.push_back(*info);
+                                         return true;
+                                     }();
+
+                if (!requeue) {
+                    dispatcher.post_event(std::make_shared<GameFinished>(
+                        info->id, (*engine1)->get_id(), (*engine2)->get_id(), gg.result, gg.reason, gg.game));
+                }
 
-                // Return the engines now we're done with them
-                const auto released1 = engine_store.release(*engine1);
-                const auto released2 = engine_store.release(*engine2);
+                // Return the engines now we're done with them, crashed engines and ones that might still be searching
+                // are replaced next game
+                const auto released1 = crashed1 || (*engine1)->timed_out() || engine_store.release(*engine1);
+                const auto released2 = crashed2 || (*engine2)->timed_out() || engine_store.release(*engine2);
 
                 if (released1) {
                     dispatcher.post_event(std::make_shared<EngineDestroyed>(99, "", ""));
@@ -347,6 +572,10 @@ auto main(const int argc, const char *const *const argv) noexcept -> int {
     std::cout << "\n";
     print_statistics(stats);
     std::cout << "\n";
+    print_search_statistics(settings.engine_settings, engine_statistics);
+    std::cout << "\n";
+    print_latency_statistics(settings.engine_settings, engine_statistics);
+    std::cout << "\n";
     std::cout << "Time taken:";
     if (tod.hours().count() > 0) {
         std::cout << " " << tod.hours().count() << "h";
@@ -0,0 +1,71 @@
+#include "adjudication.hpp"
+#include <cstdlib>
+
+namespace {
+
+// Larger than any centipawn score, so a mate always counts as decided
+constexpr int mate_score = 100'000;
+
+[[nodiscard]] auto centipawns(const SearchInfo &info) noexcept -> int {
+    if (!info.is_mate) {
+        return info.score;
+    }
+    // "mate 0" and negative counts mean the engine is the one getting mated
+    return info.score > 0 ? mate_score : -mate_score;
+}
+
+}  // namespace
+
+auto Adjudicator::update(const Side side, const SearchInfo &info) noexcept -> void {
+    m_plies++;
+
+    // A move without a score breaks the run
+    if (!info.has_score) {
+        m_last_score.reset();
+        m_resign_count = 0;
+        m_draw_count = 0;
+        return;
+    }
+
+    const auto score = side == Side::Player1 ? centipawns(info) : -centipawns(info);
+
+    if (m_last_score) {
+        const auto &resign = m_settings.resign;
+        if (score >= resign.score && *m_last_score >= resign.score) {
+            m_resign_count = m_resign_winner == Side::Player1 ? m_resign_count + 1 : 1;
+            m_resign_winner = Side::Player1;
+        } else if (score <= -resign.score && *m_last_score <= -resign.score) {
+            m_resign_count = m_resign_winner == Side::Player2 ? m_resign_count + 1 : 1;
+            m_resign_winner = Side::Player2;
+        } else {
+            m_resign_count = 0;
+        }
+
+        const auto &draw = m_settings.draw;
+        if (std::abs(score) <= draw.score && std::abs(*m_last_score) <= draw.score) {
+            m_draw_count++;
+        } else {
+            m_draw_count = 0;
+        }
+    }
+
+    m_last_score = score;
+}
+
+[[nodiscard]] auto Adjudicator::verdict() const noexcept -> std::optional<Verdict> {
+    if (m_settings.resign.enabled && m_resign_count >= m_settings.resign.count) {
+        const auto result = m_resign_winner == Side::Player1 ? GameResult::Player1Win : GameResult::Player2Win;
+        return Verdict{result, AdjudicationReason::Resign};
+    }
+
+    const auto &draw = m_settings.draw;
+    if (draw.enabled && m_draw_count >= draw.count && m_plies >= static_cast<std::size_t>(draw.minply)) {
+        return Verdict{GameResult::Draw, AdjudicationReason::Draw};
+    }
+
+    if (m_settings.maxfullmoves > 0 && m_plies >= 2 * static_cast<std::size_t>(m_settings.maxfullmoves)) {
+        return Verdict{GameResult::Draw, AdjudicationReason::Gamelength};
+    }
+
+    return std::nullopt;
+}
@@ -0,0 +1,37 @@
+#ifndef MATCH_ADJUDICATION_HPP
+#define MATCH_ADJUDICATION_HPP
+
+#include <cstddef>
+#include <optional>
+#include "engine/search_info.hpp"
+#include "games/game.hpp"
+#include "settings.hpp"
+
+struct [[nodiscard]] Verdict {
+    GameResult result = GameResult::None;
+    AdjudicationReason reason = AdjudicationReason::None;
+};
+
+// Watches the scores both engines report and ends games that are decided, drawn, or too long
+class [[nodiscard]] Adjudicator {
+   public:
+    [[nodiscard]] explicit Adjudicator(const AdjudicationSettings &settings) : m_settings(settings) {
+    }
+
+    // Called after every move with the search info of the engine that played it
+    auto update(const Side side, const SearchInfo &info) noexcept -> void;
+
+    [[nodiscard]] auto verdict() const noexcept -> std::optional<Verdict>;
+
+   private:
+    AdjudicationSettings m_settings;
+    std::size_t m_plies = 0;
+    // Score of the previous move from player 1's point of view
+    std::optional<int> m_last_score;
+    // Moves in a row both engines agreed on
+    int m_resign_count = 0;
+    int m_draw_count = 0;
+    Side m_resign_winner = Side::Player1;
+};
+
+#endif
@@ -27,6 +27,8 @@
             return "Illegal move";
         case AdjudicationReason::Gamelength:
             return "Maximum game length";
+        case AdjudicationReason::Draw:
+            return "Drawn by adjudication";
         case AdjudicationReason::GameoverMismatch:
             return "Gameover mismatch";
         case AdjudicationReason::ResultMismatch:
@@ -78,7 +80,7 @@ auto write_as_pgn(const PGNSettings &settings,
         ply++;
     }
 
-    for (const auto &movestr : game->move_history()) {
+    for (const auto movestr : game->move_history()) {
         if (ply % 2 == 0) {
             file << ply / 2 + 1 << ". ";
         }
@@ -1,23 +1,44 @@
 #include "play.hpp"
+#include "adjudication.hpp"
 #include "games/ataxx.hpp"
 #include "games/chess.hpp"
+#include "games/connect4.hpp"
 #include "games/game.hpp"
 #include "games/ugigame.hpp"
 #include "settings.hpp"
 
-[[nodiscard]] auto make_game(const GameType game_type, const std::string &fen = "startpos") -> std::shared_ptr<Game> {
+[[nodiscard]] auto make_game(const GameType game_type,
+                             const std::string &fen = "startpos",
+                             const Engine::timeout_type reply_timeout = {}) -> std::shared_ptr<Game> {
     switch (game_type) {
         case GameType::Generic:
-            return std::make_shared<UGIGame>(fen);
+            return std::make_shared<UGIGame>(fen, reply_timeout);
         case GameType::Ataxx:
             return std::make_shared<AtaxxGame>(fen);
         case GameType::Chess:
             return std::make_shared<ChessGame>(fen);
+        case GameType::ConnectFour:
+            return std::make_shared<ConnectFourGame>(fen);
         default:
             throw std::invalid_argument("Unrecognised game type");
     }
 }
 
+[[nodiscard]] auto get_timeout(const SearchSettings &tc, const bool is_p1_turn, const int timeoutbuffer)
+    -> Engine::timeout_type {
+    // Charging CPU time means a busy host can stretch a search in wall time, so only stop the ones that are far off
+    const auto scale = tc.timing == SearchSettings::Timing::Cpu ? 2 : 1;
+
+    switch (tc.type) {
+        case SearchSettings::Type::Time:
+            return std::chrono::milliseconds(scale * (is_p1_turn ? tc.p1time : tc.p2time) + timeoutbuffer);
+        case SearchSettings::Type::Movetime:
+            return std::chrono::milliseconds(scale * tc.movetime + timeoutbuffer);
+        default:
+            return {};
+    }
+}
+
 auto play_game(const GameType game_type,
                const SearchSettings &timecontrol,
                const AdjudicationSettings &adjudication,
@@ -25,17 +46,39 @@ auto play_game(const GameType game_type,
                const std::string &fen,
                const std::shared_ptr<Engine> &engine1,
                const std::shared_ptr<Engine> &engine2) -> GG {
-    auto game = make_game(game_type, fen);
+    // A silent engine loses on time instead of hanging the match
+    const auto reply_timeout = adjudication.replytimeout > 0
+                                   ? Engine::timeout_type(std::chrono::milliseconds(adjudication.replytimeout))
+                                   : std::nullopt;
+    auto game = make_game(game_type, fen, reply_timeout);
 
-    engine1->is_ready();
-    engine2->is_ready();
+    if (protocol.lean) {
+        // Ordering on the pipe guarantees every later command is seen after these
+        engine1->newgame();
+        engine2->newgame();
 
-    engine1->newgame();
-    engine2->newgame();
+        engine1->is_ready(reply_timeout);
+        engine2->is_ready(reply_timeout);
+    } else {
+        engine1->is_ready(reply_timeout);
+        engine2->is_ready(reply_timeout);
+
+        engine1->newgame();
+        engine2->newgame();
+    }
 
     auto tc = timecontrol;
     auto out_of_time = false;
     auto gameover_claimed = false;
+    auto crashed = false;
+    std::optional<Side> illegal_move;
+    std::optional<Verdict> verdict;
+    auto adjudicator = Adjudicator(adjudication);
+
+    // Generic games ask the engines about the position between moves, which they can't answer while pondering
+    const auto can_ponder = protocol.ponder && game_type != GameType::Generic;
+    std::optional<std::string> ponder1;
+    std::optional<std::string> ponder2;
 
     // Find out whose turn it is
     if (game_type == GameType::Generic) {
@@ -57,9 +100,22 @@ auto play_game(const GameType game_type,
         const auto &us = is_p1_turn ? engine1 : engine2;
         const auto &them = is_p1_turn ? engine2 : engine1;
 
+        // If the engine guessed the last move right it's already searching the current position
+        auto &ponder = is_p1_turn ? ponder1 : ponder2;
+        const auto is_ponderhit = ponder && !game->move_history().empty() && game->move_history().back() == *ponder &&
+                                  !game->is_gameover(us);
+        if (ponder && !is_ponderhit) {
+            us->stop_ponder();
+        }
+        ponder.reset();
+
         // Inform the engine of the current position
-        us->is_ready();
-        us->position(game->start_fen(), game->move_history());
+        if (!is_ponderhit) {
+            if (!protocol.lean) {
+                us->is_ready(reply_timeout);
+            }
+            us->position(game->position());
+        }
 
         // Ask if the game is over
         if (game->is_gameover(us) ||
@@ -68,11 +124,43 @@ auto play_game(const GameType game_type,
             break;
         }
 
+        if (engine1->crashed() || engine2->crashed()) {
+            crashed = true;
+            break;
+        }
+
+        // An engine didn't answer isready or a query in time, or the watchdog killed one that stopped responding
+        if (engine1->timed_out() || engine2->timed_out()) {
+            out_of_time = true;
+            break;
+        }
+
         // Get move string
+        const auto cpu0 = us->cpu_time();
         const auto t0 = std::chrono::steady_clock::now();
-        const auto movestr = us->go(tc);
+        const auto timeout = get_timeout(tc, is_p1_turn, adjudication.timeoutbuffer);
+        const auto movestr = is_ponderhit ? us->ponderhit(timeout) : us->go(tc, timeout);
         const auto t1 = std::chrono::steady_clock::now();
-        const auto dt = std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0);
+        const auto cpu1 = us->cpu_time();
+        // Prefer the time between the write of go and the read of bestmove, which leaves out our own scheduling delays
+        const auto wall_dt = std::chrono::duration_cast<std::chrono::milliseconds>(
+            us->search_time() ? std::chrono::steady_clock::duration(*us->search_time()) : t1 - t0);
+        const auto cpu_dt = cpu0 && cpu1
+                                ? std::optional(std::chrono::duration_cast<std::chrono::milliseconds>(*cpu1 - *cpu0))
+                                : std::nullopt;
+        const auto dt = tc.timing == SearchSettings::Timing::Cpu && cpu_dt ? *cpu_dt : wall_dt;
+
+        // The engine died instead of replying
+        if (engine1->crashed() || engine2->crashed()) {
+            crashed = true;
+            break;
+        }
+
+        // The engine never replied in time
+        if (engine1->timed_out() || engine2->timed_out()) {
+            out_of_time = true;
+            break;
+        }
 
         // Check time usage
         switch (tc.type) {
@@ -111,27 +199,80 @@ auto play_game(const GameType game_type,
             break;
         }
 
+        // Playing it would corrupt the board, so the engine that sent it loses straight away
+        if (!game->is_legal_move(movestr, us)) {
+            illegal_move = is_p1_turn ? Side::Player1 : Side::Player2;
+            break;
+        }
+
         game->makemove(movestr);
+        game->add_move_info(MoveInfo{is_p1_turn ? Side::Player1 : Side::Player2, us->search_info(), wall_dt, cpu_dt});
+        adjudicator.update(is_p1_turn ? Side::Player1 : Side::Player2, us->search_info());
+
+        // Stop games that are decided or have gone on too long, unless the move just ended them anyway
+        if (const auto v = adjudicator.verdict(); v && !game->is_gameover(them)) {
+            verdict = v;
+            break;
+        }
+
+        // Let the engine think about the reply it expects while the opponent searches
+        if (can_ponder && us->ponder_move() && game->is_legal_move(*us->ponder_move(), them)) {
+            // Compared with the history later, which may spell the move differently from the engine
+            ponder = game->canonical_move(*us->ponder_move());
+            auto position = game->position();
+            position.push_back(*ponder);
+            us->position(position);
+            us->go_ponder(tc);
+        }
+    }
+
+    // Nothing left to ponder on
+    if (ponder1) {
+        engine1->stop_ponder();
+    }
+    if (ponder2) {
+        engine2->stop_ponder();
     }
 
     auto result = GameResult::None;
     auto adjudicated = AdjudicationReason::None;
 
-    if (out_of_time) {
-        result = game->turn() == Side::Player1 ? GameResult::Player2Win : GameResult::Player1Win;
+    if (crashed) {
+        result = engine1->crashed() ? GameResult::Player2Win : GameResult::Player1Win;
+        adjudicated = AdjudicationReason::Crash;
+    } else if (out_of_time) {
+        // Usually the side to move, unless the other engine was the one that stopped responding
+        const auto p1_lost = engine1->timed_out() || (!engine2->timed_out() && game->turn() == Side::Player1);
+        result = p1_lost ? GameResult::Player2Win : GameResult::Player1Win;
         adjudicated = AdjudicationReason::Timeout;
+    } else if (illegal_move) {
+        result = *illegal_move == Side::Player1 ? GameResult::Player2Win : GameResult::Player1Win;
+        adjudicated = AdjudicationReason::IllegalMove;
+    } else if (verdict) {
+        result = verdict->result;
+        adjudicated = verdict->reason;
     } else if (gameover_claimed) {
-        engine1->is_ready();
-        engine1->position(game->start_fen(), game->move_history());
+        if (!protocol.lean) {
+            engine1->is_ready(reply_timeout);
+        }
+        engine1->position(game->position());
         const auto gameover1 = game->is_gameover(engine1);
         const auto result1 = game->get_result(engine1);
 
-        engine2->is_ready();
-        engine2->position(game->start_fen(), game->move_history());
+        if (!protocol.lean) {
+            engine2->is_ready(reply_timeout);
+        }
+        engine2->position(game->position());
         const auto gameover2 = game->is_gameover(engine2);
         const auto result2 = game->get_result(engine2);
 
-        if (gameover1 != gameover2) {
+        if (engine1->crashed() || engine2->crashed()) {
+            result = engine1->crashed() ? GameResult::Player2Win : GameResult::Player1Win;
+            adjudicated = AdjudicationReason::Crash;
+        } else if (engine1->timed_out() || engine2->timed_out()) {
+            result = engine1->timed_out() ? GameResult::Player2Win : GameResult::Player1Win;
+            adjudicated = AdjudicationReason::Timeout;
+        } else if (gameover1 != gameover2) {
             adjudicated = AdjudicationReason::GameoverMismatch;
         } else if (result1 != result2) {
             adjudicated = AdjudicationReason::ResultMismatch;
@@ -10,6 +10,7 @@ auto print_settings(const MatchSettings &settings) noexcept -> void {
     std::cout << "- threads " << settings.num_threads << "\n";
     std::cout << "- games " << settings.num_games << "\n";
     std::cout << "- store size " << settings.engine_store_size << "\n";
+    std::cout << "- prespawn " << settings.num_prespawn << "\n";
     switch (settings.timecontrol.type) {
         case SearchSettings::Type::Time:
             std::cout << "- tc " << settings.timecontrol.p1time << "+" << settings.timecontrol.p1inc << "ms\n";
@@ -24,9 +25,18 @@ auto print_settings(const MatchSettings &settings) noexcept -> void {
             std::cout << "- tc " << settings.timecontrol.nodes << "nodes\n";
             break;
     }
+    std::cout << "- timing " << (settings.timecontrol.timing == SearchSettings::Timing::Cpu ? "cpu" : "wall") << "\n";
     std::cout << "- openings_path " << settings.openings_path << "\n";
     std::cout << "- timeoutbuffer " << settings.adjudication.timeoutbuffer << "ms\n";
+    std::cout << "- replytimeout " << settings.adjudication.replytimeout << "ms\n";
     std::cout << "- maxfullmoves " << settings.adjudication.maxfullmoves << "\n";
+    std::cout << "- resign adjudication " << settings.adjudication.resign.enabled << "\n";
+    std::cout << "- draw adjudication " << settings.adjudication.draw.enabled << "\n";
+    std::cout << "- lean protocol " << settings.protocol.lean << "\n";
+    std::cout << "- ponder " << settings.protocol.ponder << "\n";
+    std::cout << "- affinity " << settings.affinity.enabled << "\n";
+    std::cout << "- stderr log " << settings.stderr_log.enabled << "\n";
+    std::cout << "- watchdog " << settings.watchdog.enabled << "\n";
     std::cout << "- update_frequency " << settings.update_frequency << "\n";
     std::cout << "- debug " << settings.debug << "\n";
     std::cout << "- repeat " << settings.repeat << "\n";
@@ -43,6 +53,9 @@ auto print_settings(const MatchSettings &settings) noexcept -> void {
         case GameType::Chess:
             std::cout << "\nUsing first class support for Chess\n";
             break;
+        case GameType::ConnectFour:
+            std::cout << "\nUsing first class support for Connect Four\n";
+            break;
     }
 }
 
@@ -80,11 +93,15 @@ auto print_settings(const MatchSettings &settings) noexcept -> void {
                 settings.game_type = GameType::Ataxx;
             } else if (value == "chess") {
                 settings.game_type = GameType::Chess;
+            } else if (value == "connect4") {
+                settings.game_type = GameType::ConnectFour;
             } else {
                 throw std::invalid_argument("Unrecognised game type");
             }
         } else if (key == "concurrency") {
             settings.num_threads = value.get<int>();
+        } else if (key == "prespawn") {
+            settings.num_prespawn = value.get<int>();
         } else if (key == "ratinginterval") {
             settings.update_frequency = value.get<int>();
         } else if (key == "debug") {
@@ -103,6 +120,10 @@ auto print_settings(const MatchSettings &settings) noexcept -> void {
             for (const auto &[a, b] : value.items()) {
                 if (a == "askturn") {
                     settings.protocol.ask_turn = b.get<bool>();
+                } else if (a == "lean") {
+                    settings.protocol.lean = b.get<bool>();
+                } else if (a == "ponder") {
+                    settings.protocol.ponder = b.get<bool>();
                 } else if (a == "gameover") {
                     if (b.get<std::string>() == "tomove") {
                         settings.protocol.gameover = QueryGameover::Tomove;
@@ -111,12 +132,68 @@ auto print_settings(const MatchSettings &settings) noexcept -> void {
                     }
                 }
             }
+        } else if (key == "affinity") {
+            for (const auto &[a, b] : value.items()) {
+                if (a == "enabled") {
+                    settings.affinity.enabled = b.get<bool>();
+                } else if (a == "smt") {
+                    settings.affinity.smt = b.get<bool>();
+                } else if (a == "numa") {
+                    settings.affinity.numa = b.get<bool>();
+                }
+            }
+        } else if (key == "stderr") {
+            for (const auto &[a, b] : value.items()) {
+                if (a == "enabled") {
+                    settings.stderr_log.enabled = b.get<bool>();
+                } else if (a == "directory") {
+                    settings.stderr_log.directory = b.get<std::string>();
+                } else if (a == "maxbytes") {
+                    settings.stderr_log.max_bytes = b.get<std::size_t>();
+                } else if (a == "backups") {
+                    settings.stderr_log.num_backups = b.get<std::size_t>();
+                }
+            }
+        } else if (key == "watchdog") {
+            for (const auto &[a, b] : value.items()) {
+                if (a == "enabled") {
+                    settings.watchdog.enabled = b.get<bool>();
+                } else if (a == "grace") {
+                    settings.watchdog.grace = b.get<int>();
+                } else if (a == "hanglimit") {
+                    settings.watchdog.hang_limit = b.get<int>();
+                }
+            }
         } else if (key == "adjudication") {
             for (const auto &[a, b] : value.items()) {
                 if (a == "timeoutbuffer") {
                     settings.adjudication.timeoutbuffer = b.get<int>();
+                } else if (a == "replytimeout") {
+                    settings.adjudication.replytimeout = b.get<int>();
                 } else if (a == "maxfullmoves") {
                     settings.adjudication.maxfullmoves = b.get<int>();
+                } else if (a == "resign") {
+                    for (const auto &[c, d] : b.items()) {
+                        if (c == "enabled") {
+                            settings.adjudication.resign.enabled = d.get<bool>();
+                        } else if (c == "score") {
+                            settings.adjudication.resign.score = d.get<int>();
+                        } else if (c == "count") {
+                            settings.adjudication.resign.count = d.get<int>();
+                        }
+                    }
+                } else if (a == "draw") {
+                    for (const auto &[c, d] : b.items()) {
+                        if (c == "enabled") {
+                            settings.adjudication.draw.enabled = d.get<bool>();
+                        } else if (c == "score") {
+                            settings.adjudication.draw.score = d.get<int>();
+                        } else if (c == "count") {
+                            settings.adjudication.draw.count = d.get<int>();
+                        } else if (c == "minply") {
+                            settings.adjudication.draw.minply = d.get<int>();
+                        }
+                    }
                 }
             }
         } else if (key == "timecontrol") {
@@ -132,6 +209,12 @@ auto print_settings(const MatchSettings &settings) noexcept -> void {
                     } else if (b == "nodes") {
                         settings.timecontrol.type = SearchSettings::Type::Nodes;
                     }
+                } else if (a == "timing") {
+                    if (b == "wall") {
+                        settings.timecontrol.timing = SearchSettings::Timing::Wall;
+                    } else if (b == "cpu") {
+                        settings.timecontrol.timing = SearchSettings::Timing::Cpu;
+                    }
                 } else if (a == "time") {
                     settings.timecontrol.p1time = b.get<int>();
                     settings.timecontrol.p2time = b.get<int>();
@@ -224,9 +307,13 @@ auto print_settings(const MatchSettings &settings) noexcept -> void {
             } else if (a == "protocol") {
                 if (b == "UGI") {
                     gg.protocol = EngineProtocol::UGI;
+                } else if (b == "Plugin") {
+                    gg.protocol = EngineProtocol::Plugin;
                 } else {
                     if (settings.game_type == GameType::Generic) {
                         throw std::invalid_argument("Generic game mode must use the UGI protocol");
+                    } else if (settings.game_type == GameType::ConnectFour) {
+                        throw std::invalid_argument("Connect Four must use the UGI protocol");
                     } else if (b == "UAI") {
                         gg.protocol = EngineProtocol::UAI;
                     } else if (b == "UCI") {
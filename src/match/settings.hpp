@@ -23,14 +23,62 @@ struct [[nodiscard]] SPRTSettings {
     float elo1 = 5.0f;
 };
 
+// Scores are in centipawns from the point of view of the engine that reported them
+struct [[nodiscard]] ResignSettings {
+    bool enabled = false;
+    // Both engines have to agree one side is at least this far ahead
+    int score = 1000;
+    // For this many moves in a row
+    int count = 6;
+};
+
+struct [[nodiscard]] DrawSettings {
+    bool enabled = false;
+    // Both engines have to agree the score is at most this far from zero
+    int score = 10;
+    // For this many moves in a row
+    int count = 10;
+    // And not before this many moves have been played
+    int minply = 80;
+};
+
 struct [[nodiscard]] AdjudicationSettings {
     int timeoutbuffer = 10;
+    // Longest wait for replies to isready and queries, 0 waits forever
+    int replytimeout = 10000;
+    // 0 lets games run forever
     int maxfullmoves = 0;
+    ResignSettings resign;
+    DrawSettings draw;
 };
 
 struct [[nodiscard]] ProtocolSettings {
     QueryGameover gameover = QueryGameover::Tomove;
     bool ask_turn = false;
+    bool lean = false;
+    bool ponder = false;
+};
+
+struct [[nodiscard]] AffinitySettings {
+    bool enabled = false;
+    bool smt = false;
+    bool numa = true;
+};
+
+struct [[nodiscard]] StderrSettings {
+    bool enabled = false;
+    std::string directory = "logs";
+    // Size a log reaches before it's rotated, 0 never rotates
+    std::size_t max_bytes = 1024 * 1024;
+    std::size_t num_backups = 1;
+};
+
+struct [[nodiscard]] WatchdogSettings {
+    bool enabled = false;
+    // Time a late search gets to answer stop before it's killed
+    int grace = 250;
+    // Longest wait without a deadline of its own before the engine is killed, 0 never kills
+    int hang_limit = 0;
 };
 
 struct [[nodiscard]] MatchSettings {
@@ -38,6 +86,7 @@ struct [[nodiscard]] MatchSettings {
     std::size_t num_threads = 1;
     int num_games = 1;
     int engine_store_size = 2;
+    int num_prespawn = 0;
     int update_frequency = 10;
     std::string openings_path;
     TournamentType tournament_type = TournamentType::RoundRobin;
@@ -47,6 +96,9 @@ struct [[nodiscard]] MatchSettings {
     PGNSettings pgn;
     AdjudicationSettings adjudication;
     ProtocolSettings protocol;
+    AffinitySettings affinity;
+    StderrSettings stderr_log;
+    WatchdogSettings watchdog;
     bool shuffle_openings = false;
     bool repeat = true;
     bool debug = false;
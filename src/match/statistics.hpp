@@ -1,10 +1,14 @@
 #ifndef MATCH_STATISTICS_HPP
 #define MATCH_STATISTICS_HPP
 
+#include "engine/engine.hpp"
+
 struct [[nodiscard]] MatchStatistics {
     // Engines
     int num_engine_loads = 0;
     int num_engine_unloads = 0;
+    // Total time spent starting engines
+    StartupTimes engine_startup;
     // Games
     int num_games_finished = 0;
     int num_games_total = 0;
@@ -0,0 +1,132 @@
+#ifndef CUTEGAMES_SPAWNER_HPP
+#define CUTEGAMES_SPAWNER_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Keeps a number of ready objects per id, created in the background so they're off the critical path
+template <typename T>
+class Spawner {
+   public:
+    using entry_ptr_type = std::shared_ptr<T>;
+    using factory_type = std::function<entry_ptr_type(const std::size_t)>;
+
+    [[nodiscard]] Spawner(const std::size_t num_ids,
+                          const std::size_t per_id,
+                          const std::size_t num_threads,
+                          factory_type factory)
+        : m_per_id(per_id), m_factory(std::move(factory)), m_pools(num_ids) {
+        for (std::size_t i = 0; i < num_threads; ++i) {
+            m_threads.emplace_back([this]() {
+                run();
+            });
+        }
+    }
+
+    Spawner(const Spawner &) = delete;
+
+    auto operator=(const Spawner &) -> Spawner & = delete;
+
+    ~Spawner() {
+        {
+            std::scoped_lock lock(m_mutex);
+            m_quit = true;
+        }
+        m_cv.notify_all();
+
+        for (auto &thread : m_threads) {
+            if (thread.joinable()) {
+                thread.join();
+            }
+        }
+    }
+
+    // Take a ready object if there is one, a replacement is created in the background
+    [[nodiscard]] auto get(const std::size_t id) -> std::optional<entry_ptr_type> {
+        std::scoped_lock lock(m_mutex);
+
+        if (id >= m_pools.size() || m_pools[id].ready.empty()) {
+            return {};
+        }
+
+        auto ptr = m_pools[id].ready.back();
+        m_pools[id].ready.pop_back();
+        m_cv.notify_one();
+        return ptr;
+    }
+
+    [[nodiscard]] auto size(const std::size_t id) const -> std::size_t {
+        std::scoped_lock lock(m_mutex);
+        return id < m_pools.size() ? m_pools[id].ready.size() : 0;
+    }
+
+   private:
+    struct Pool {
+        std::vector<entry_ptr_type> ready;
+        std::size_t pending = 0;
+        bool failed = false;
+    };
+
+    // Find an id that's short of ready objects, must be called with the mutex held
+    [[nodiscard]] auto next_id() const noexcept -> std::optional<std::size_t> {
+        for (std::size_t id = 0; id < m_pools.size(); ++id) {
+            const auto &pool = m_pools[id];
+            if (!pool.failed && pool.ready.size() + pool.pending < m_per_id) {
+                return id;
+            }
+        }
+        return {};
+    }
+
+    auto run() -> void {
+        while (true) {
+            std::size_t id = 0;
+
+            {
+                std::unique_lock lock(m_mutex);
+                m_cv.wait(lock, [this]() {
+                    return m_quit || next_id();
+                });
+
+                if (m_quit) {
+                    return;
+                }
+
+                id = *next_id();
+                m_pools[id].pending++;
+            }
+
+            auto ptr = entry_ptr_type();
+            try {
+                ptr = m_factory(id);
+            } catch (...) {
+            }
+
+            std::scoped_lock lock(m_mutex);
+            m_pools[id].pending--;
+            if (ptr) {
+                m_pools[id].ready.emplace_back(ptr);
+            } else {
+                // Don't keep retrying something that can't be created, the worker will find out itself
+                m_pools[id].failed = true;
+            }
+        }
+    }
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::size_t m_per_id = 0;
+    factory_type m_factory;
+    std::vector<Pool> m_pools;
+    std::vector<std::thread> m_threads;
+    bool m_quit = false;
+};
+
+#endif
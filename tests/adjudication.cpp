@@ -0,0 +1,126 @@
+#include <doctest/doctest.h>
+#include <match/adjudication.hpp>
+
+[[nodiscard]] static auto cp(const int score) -> SearchInfo {
+    auto info = SearchInfo();
+    info.score = score;
+    info.has_score = true;
+    return info;
+}
+
+[[nodiscard]] static auto mate(const int moves) -> SearchInfo {
+    auto info = cp(moves);
+    info.is_mate = true;
+    return info;
+}
+
+// Play moves alternating between the players, starting with player 1
+static auto play(Adjudicator &adjudicator, const std::initializer_list<SearchInfo> infos) -> void {
+    auto side = Side::Player1;
+    for (const auto &info : infos) {
+        adjudicator.update(side, info);
+        side = !side;
+    }
+}
+
+TEST_CASE("Adjudication - Disabled") {
+    auto adjudicator = Adjudicator(AdjudicationSettings{});
+    for (int i = 0; i < 1000; ++i) {
+        adjudicator.update(i % 2 ? Side::Player2 : Side::Player1, cp(i % 2 ? -5000 : 5000));
+    }
+    REQUIRE(!adjudicator.verdict());
+}
+
+TEST_CASE("Adjudication - Game length") {
+    auto settings = AdjudicationSettings{};
+    settings.maxfullmoves = 3;
+    auto adjudicator = Adjudicator(settings);
+
+    play(adjudicator, {SearchInfo(), SearchInfo(), SearchInfo(), SearchInfo(), SearchInfo()});
+    REQUIRE(!adjudicator.verdict());
+
+    adjudicator.update(Side::Player2, SearchInfo());
+    const auto verdict = adjudicator.verdict();
+    REQUIRE(verdict);
+    REQUIRE(verdict->result == GameResult::Draw);
+    REQUIRE(verdict->reason == AdjudicationReason::Gamelength);
+}
+
+TEST_CASE("Adjudication - Resign") {
+    auto settings = AdjudicationSettings{};
+    settings.resign.enabled = true;
+    settings.resign.score = 500;
+    settings.resign.count = 2;
+
+    SUBCASE("Player 1 wins") {
+        auto adjudicator = Adjudicator(settings);
+        play(adjudicator, {cp(600), cp(-600)});
+        REQUIRE(!adjudicator.verdict());
+        play(adjudicator, {cp(700)});
+        const auto verdict = adjudicator.verdict();
+        REQUIRE(verdict);
+        REQUIRE(verdict->result == GameResult::Player1Win);
+        REQUIRE(verdict->reason == AdjudicationReason::Resign);
+    }
+
+    SUBCASE("Player 2 wins on a mate score") {
+        auto adjudicator = Adjudicator(settings);
+        play(adjudicator, {cp(-600), mate(3), mate(-2)});
+        const auto verdict = adjudicator.verdict();
+        REQUIRE(verdict);
+        REQUIRE(verdict->result == GameResult::Player2Win);
+        REQUIRE(verdict->reason == AdjudicationReason::Resign);
+    }
+
+    SUBCASE("Engines disagree") {
+        auto adjudicator = Adjudicator(settings);
+        play(adjudicator, {cp(600), cp(600), cp(600), cp(600), cp(600), cp(600)});
+        REQUIRE(!adjudicator.verdict());
+    }
+
+    SUBCASE("The run is broken") {
+        auto adjudicator = Adjudicator(settings);
+        play(adjudicator, {cp(600), cp(-600), cp(100), cp(-600), cp(600)});
+        REQUIRE(!adjudicator.verdict());
+        adjudicator.update(Side::Player2, cp(-600));
+        REQUIRE(adjudicator.verdict());
+    }
+
+    SUBCASE("Missing scores") {
+        auto adjudicator = Adjudicator(settings);
+        play(adjudicator, {cp(600), cp(-600), SearchInfo(), cp(-600)});
+        REQUIRE(!adjudicator.verdict());
+    }
+}
+
+TEST_CASE("Adjudication - Draw") {
+    auto settings = AdjudicationSettings{};
+    settings.draw.enabled = true;
+    settings.draw.score = 10;
+    settings.draw.count = 3;
+    settings.draw.minply = 6;
+
+    SUBCASE("Level") {
+        auto adjudicator = Adjudicator(settings);
+        play(adjudicator, {cp(0), cp(5), cp(-10), cp(10), cp(0)});
+        REQUIRE(!adjudicator.verdict());
+        adjudicator.update(Side::Player2, cp(-3));
+        const auto verdict = adjudicator.verdict();
+        REQUIRE(verdict);
+        REQUIRE(verdict->result == GameResult::Draw);
+        REQUIRE(verdict->reason == AdjudicationReason::Draw);
+    }
+
+    SUBCASE("Too early") {
+        settings.draw.minply = 20;
+        auto adjudicator = Adjudicator(settings);
+        play(adjudicator, {cp(0), cp(0), cp(0), cp(0), cp(0), cp(0)});
+        REQUIRE(!adjudicator.verdict());
+    }
+
+    SUBCASE("Not level") {
+        auto adjudicator = Adjudicator(settings);
+        play(adjudicator, {cp(0), cp(0), cp(0), cp(50), cp(0), cp(0)});
+        REQUIRE(!adjudicator.verdict());
+    }
+}
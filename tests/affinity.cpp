@@ -0,0 +1,60 @@
+#include <doctest/doctest.h>
+#include <engine/affinity.hpp>
+
+TEST_CASE("parse_cpu_list()") {
+    REQUIRE(parse_cpu_list("") == CpuSet{});
+    REQUIRE(parse_cpu_list("0") == CpuSet{0});
+    REQUIRE(parse_cpu_list("0-3") == CpuSet{0, 1, 2, 3});
+    REQUIRE(parse_cpu_list("8,0-1,10-11\n") == CpuSet{0, 1, 8, 10, 11});
+    REQUIRE(parse_cpu_list("2,2,1-2") == CpuSet{1, 2});
+    REQUIRE(parse_cpu_list("a,3-,4") == CpuSet{4});
+}
+
+TEST_CASE("make_cpu_slots()") {
+    // 2 NUMA nodes, 4 cores each, SMT siblings are cpu+8
+    auto cores = std::vector<CpuCore>();
+    for (int i = 0; i < 8; ++i) {
+        cores.emplace_back(CpuCore{.node = i / 4, .cpus = {i, i + 8}});
+    }
+
+    SUBCASE("One core per slot") {
+        const auto slots = make_cpu_slots(cores, 8, false, true);
+        REQUIRE(slots.size() == 8);
+        for (int i = 0; i < 8; ++i) {
+            REQUIRE(slots[i] == CpuSet{i});
+        }
+    }
+
+    SUBCASE("SMT siblings") {
+        const auto slots = make_cpu_slots(cores, 4, true, true);
+        REQUIRE(slots.size() == 4);
+        REQUIRE(slots[0] == CpuSet{0, 8, 1, 9});
+        REQUIRE(slots[3] == CpuSet{6, 14, 7, 15});
+    }
+
+    SUBCASE("NUMA nodes") {
+        // Slots never span both nodes
+        const auto slots = make_cpu_slots(cores, 3, false, true);
+        REQUIRE(slots.size() == 3);
+        REQUIRE(slots[0] == CpuSet{0, 1});
+        REQUIRE(slots[1] == CpuSet{2, 3});
+        REQUIRE(slots[2] == CpuSet{4, 5, 6, 7});
+
+        const auto ignored = make_cpu_slots(cores, 3, false, false);
+        REQUIRE(ignored.size() == 3);
+        REQUIRE(ignored[1] == CpuSet{2, 3, 4});
+    }
+
+    SUBCASE("More slots than cores") {
+        const auto slots = make_cpu_slots(cores, 10, false, false);
+        REQUIRE(slots.size() == 10);
+        for (const auto &slot : slots) {
+            REQUIRE(slot.size() == 1);
+        }
+    }
+
+    SUBCASE("Nothing") {
+        REQUIRE(make_cpu_slots(cores, 0, false, true).empty());
+        REQUIRE(make_cpu_slots({}, 4, false, true).empty());
+    }
+}
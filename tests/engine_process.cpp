@@ -0,0 +1,31 @@
+#include <doctest/doctest.h>
+#include <chrono>
+#include <engine/engine_uai.hpp>
+#include <engine/engine_uci.hpp>
+#include <engine/engine_ugi.hpp>
+#include <memory>
+
+namespace {
+
+// Never answers anything, as if the engine had hung on startup
+template <typename T>
+[[nodiscard]] auto make_silent_engine() -> std::shared_ptr<Engine> {
+    return std::make_shared<T>(0, "sleep", "10");
+}
+
+}  // namespace
+
+TEST_CASE("ProcessEngine - Silent handshake") {
+    for (const auto &engine : {make_silent_engine<UGIEngine>(),
+                               make_silent_engine<UAIEngine>(),
+                               make_silent_engine<UCIEngine>()}) {
+        const auto t0 = std::chrono::steady_clock::now();
+        engine->init(std::chrono::milliseconds(100));
+        const auto t1 = std::chrono::steady_clock::now();
+
+        REQUIRE(engine->timed_out());
+        REQUIRE(!engine->crashed());
+        REQUIRE(t1 - t0 >= std::chrono::milliseconds(100));
+        REQUIRE(t1 - t0 < std::chrono::seconds(5));
+    }
+}
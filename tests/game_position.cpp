@@ -0,0 +1,63 @@
+#include <doctest/doctest.h>
+#include <games/game_position.hpp>
+#include <string>
+
+TEST_CASE("GamePosition - Command") {
+    auto position = GamePosition();
+    REQUIRE(position.command() == "position startpos");
+    position.push_back("e2e4");
+    REQUIRE(position.command() == "position startpos moves e2e4");
+    position.push_back("e7e5");
+    REQUIRE(position.command() == "position startpos moves e2e4 e7e5");
+    REQUIRE(position.moves().size() == 2);
+
+    REQUIRE(GamePosition("").command() == "position startpos");
+    REQUIRE(GamePosition("x5o/7/7/7/7/7/o5x x 0 1").command() == "position fen x5o/7/7/7/7/7/o5x x 0 1");
+}
+
+TEST_CASE("GamePosition - Canonical moves") {
+    auto position = GamePosition("startpos", MoveEncoding::Chess);
+    position.push_back("E2E4");
+    position.push_back("a7a8Q");
+    REQUIRE(position.command() == "position startpos moves e2e4 a7a8q");
+}
+
+TEST_CASE("GamePosition - Moves after an earlier position") {
+    const auto fen = std::string("x5o/7/7/7/7/7/o5x x 0 1");
+    auto position = GamePosition(fen);
+    const auto empty = position;
+    position.push_back("b2");
+    const auto one = position;
+    position.push_back("f6");
+    position.push_back("c3");
+
+    REQUIRE(position.moves_after(empty.command()) == " b2 f6 c3");
+    REQUIRE(position.moves_after(one.command()) == " f6 c3");
+    REQUIRE(position != one);
+
+    // Nothing new
+    REQUIRE(position.moves_after(position.command()).empty());
+    // A different game
+    REQUIRE(position.moves_after(GamePosition().command()).empty());
+    REQUIRE(position.moves_after(GamePosition("x5o/7/7/7/7/7/o5x x 0").command()).empty());
+    auto other = GamePosition(fen);
+    other.push_back("c3");
+    REQUIRE(position.moves_after(other.command()).empty());
+    // Later in the game
+    auto later = position;
+    later.push_back("a1");
+    REQUIRE(position.moves_after(later.command()).empty());
+}
+
+TEST_CASE("GamePosition - Clear") {
+    auto position = GamePosition("x5o/7/7/7/7/7/o5x x 0 1");
+    position.push_back("b2");
+    position.push_back("f6");
+    position.clear();
+    REQUIRE(position.moves().empty());
+    REQUIRE(position.command() == "position fen x5o/7/7/7/7/7/o5x x 0 1");
+    REQUIRE(position == GamePosition("x5o/7/7/7/7/7/o5x x 0 1"));
+
+    position.push_back("c3");
+    REQUIRE(position.command() == "position fen x5o/7/7/7/7/7/o5x x 0 1 moves c3");
+}
@@ -4,6 +4,7 @@
 #include <libataxx/position.hpp>
 #include <match/play.hpp>
 #include <match/settings.hpp>
+#include <optional>
 #include <sstream>
 #include <stdexcept>
 #include <string>
@@ -17,10 +18,10 @@ class TestEngine final : public Engine {
         return true;
     }
 
-    virtual auto init() -> void override {
+    virtual auto init(const timeout_type) -> void override {
     }
 
-    virtual auto is_ready() -> void override {
+    virtual auto is_ready(const timeout_type) -> void override {
     }
 
     virtual auto newgame() -> void override {
@@ -33,10 +34,10 @@ class TestEngine final : public Engine {
     virtual auto stop() -> void override {
     }
 
-    virtual auto position(const std::string &start_fen, const std::vector<std::string> &move_history) -> void override {
-        m_pos.set_fen(start_fen);
-        for (const auto &movestr : move_history) {
-            const auto move = libataxx::Move::from_uai(movestr);
+    virtual auto position(const GamePosition &position) -> void override {
+        m_pos.set_fen(position.start_fen());
+        for (const auto movestr : position.moves()) {
+            const auto move = libataxx::Move::from_uai(std::string(movestr));
             m_pos.makemove(move);
         }
     }
@@ -44,23 +45,26 @@ class TestEngine final : public Engine {
     virtual auto set_option(const std::string &, const std::string &) -> void override {
     }
 
-    [[nodiscard]] virtual auto go(const SearchSettings &) -> std::string override {
+    [[nodiscard]] virtual auto go(const SearchSettings &, const timeout_type) -> std::string override {
         num_go_received++;
+        if (illegal_move) {
+            return *illegal_move;
+        }
         const auto moves = m_pos.legal_moves();
         std::stringstream ss;
         ss << moves.at(0);
         return ss.str();
     }
 
-    [[nodiscard]] virtual auto query_p1turn() -> bool override {
+    [[nodiscard]] virtual auto query_p1turn(const timeout_type) -> bool override {
         return m_pos.get_turn() == libataxx::Side::Black;
     }
 
-    [[nodiscard]] virtual auto query_gameover() -> bool override {
+    [[nodiscard]] virtual auto query_gameover(const timeout_type) -> bool override {
         return m_pos.is_gameover();
     }
 
-    [[nodiscard]] virtual auto query_result() -> std::string override {
+    [[nodiscard]] virtual auto query_result(const timeout_type) -> std::string override {
         switch (m_pos.get_result()) {
             case libataxx::Result::BlackWin:
                 return "p1win";
@@ -76,6 +80,8 @@ class TestEngine final : public Engine {
     }
 
     int num_go_received = 0;
+    // Sent instead of a legal move if set
+    std::optional<std::string> illegal_move;
 
    private:
     libataxx::Position m_pos;
@@ -89,10 +95,10 @@ class StrongTestEngine final : public Engine {
         return true;
     }
 
-    virtual auto init() -> void override {
+    virtual auto init(const timeout_type) -> void override {
     }
 
-    virtual auto is_ready() -> void override {
+    virtual auto is_ready(const timeout_type) -> void override {
     }
 
     virtual auto newgame() -> void override {
@@ -105,10 +111,10 @@ class StrongTestEngine final : public Engine {
     virtual auto stop() -> void override {
     }
 
-    virtual auto position(const std::string &start_fen, const std::vector<std::string> &move_history) -> void override {
-        m_pos.set_fen(start_fen);
-        for (const auto &movestr : move_history) {
-            const auto move = libataxx::Move::from_uai(movestr);
+    virtual auto position(const GamePosition &position) -> void override {
+        m_pos.set_fen(position.start_fen());
+        for (const auto movestr : position.moves()) {
+            const auto move = libataxx::Move::from_uai(std::string(movestr));
             m_pos.makemove(move);
         }
     }
@@ -116,7 +122,7 @@ class StrongTestEngine final : public Engine {
     virtual auto set_option(const std::string &, const std::string &) -> void override {
     }
 
-    [[nodiscard]] virtual auto go(const SearchSettings &) -> std::string override {
+    [[nodiscard]] virtual auto go(const SearchSettings &, const timeout_type) -> std::string override {
         num_go_received++;
         const auto moves = m_pos.legal_moves();
         std::stringstream ss;
@@ -143,15 +149,15 @@ class StrongTestEngine final : public Engine {
         return ss.str();
     }
 
-    [[nodiscard]] virtual auto query_p1turn() -> bool override {
+    [[nodiscard]] virtual auto query_p1turn(const timeout_type) -> bool override {
         return m_pos.get_turn() == libataxx::Side::Black;
     }
 
-    [[nodiscard]] virtual auto query_gameover() -> bool override {
+    [[nodiscard]] virtual auto query_gameover(const timeout_type) -> bool override {
         return m_pos.is_gameover();
     }
 
-    [[nodiscard]] virtual auto query_result() -> std::string override {
+    [[nodiscard]] virtual auto query_result(const timeout_type) -> std::string override {
         switch (m_pos.get_result()) {
             case libataxx::Result::BlackWin:
                 return "p1win";
@@ -174,8 +180,8 @@ class StrongTestEngine final : public Engine {
 
 [[nodiscard]] static auto get_final(const std::shared_ptr<Game> &game) -> libataxx::Position {
     auto pos = libataxx::Position(game->start_fen());
-    for (const auto &movestr : game->move_history()) {
-        const auto move = libataxx::Move::from_uai(movestr);
+    for (const auto movestr : game->move_history()) {
+        const auto move = libataxx::Move::from_uai(std::string(movestr));
 
         REQUIRE(!pos.is_gameover());
         REQUIRE_EQ(pos.get_result(), libataxx::Result::None);
@@ -420,6 +426,42 @@ TEST_CASE("Ataxx - Draw") {
     }
 }
 
+TEST_CASE("Ataxx - Illegal move") {
+    const std::array movestrs = {
+        // Nobody can reach the centre from startpos
+        "d4",
+        "a1d4",
+        // Not a move at all
+        "0000",
+        "",
+        "e9",
+        "nonsense",
+    };
+
+    const auto game_type = GameType::Ataxx;
+    const auto timecontrol = SearchSettings{};
+    const auto adjudication = AdjudicationSettings{};
+    const auto protocol = ProtocolSettings{};
+    auto engine1 = std::make_shared<TestEngine>();
+    auto engine2 = std::make_shared<TestEngine>();
+
+    for (const auto &movestr : movestrs) {
+        engine1->illegal_move = movestr;
+
+        for (const auto is_engine1_p1 : {true, false}) {
+            const auto &p1 = is_engine1_p1 ? engine1 : engine2;
+            const auto &p2 = is_engine1_p1 ? engine2 : engine1;
+            const auto gg = play_game(game_type, timecontrol, adjudication, protocol, "startpos", p1, p2);
+
+            REQUIRE(gg.reason == AdjudicationReason::IllegalMove);
+            REQUIRE(gg.result == (is_engine1_p1 ? GameResult::Player2Win : GameResult::Player1Win));
+            // The illegal move never reached the board
+            REQUIRE(gg.game->move_history().size() == (is_engine1_p1 ? 0 : 1));
+            REQUIRE(!get_final(gg.game).is_gameover());
+        }
+    }
+}
+
 TEST_CASE("Ataxx - Strong vs Weak") {
     const std::array fens = {
         // Tournament openings
@@ -1 +1,116 @@
 #include <doctest/doctest.h>
+#include <array>
+#include <engine/engine.hpp>
+#include <games/chess.hpp>
+#include <match/play.hpp>
+#include <match/settings.hpp>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "games/game.hpp"
+
+namespace {
+
+constexpr auto startpos = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+}  // namespace
+
+// Plays the next move of a fixed opening
+class TestEngine final : public Engine {
+   public:
+    virtual ~TestEngine() override = default;
+
+    [[nodiscard]] virtual auto is_running() -> bool override {
+        return true;
+    }
+
+    virtual auto init(const timeout_type) -> void override {
+    }
+
+    virtual auto is_ready(const timeout_type) -> void override {
+    }
+
+    virtual auto newgame() -> void override {
+    }
+
+    virtual auto quit() -> void override {
+    }
+
+    virtual auto stop() -> void override {
+    }
+
+    virtual auto position(const GamePosition &position) -> void override {
+        m_ply = position.moves().size();
+    }
+
+    virtual auto set_option(const std::string &, const std::string &) -> void override {
+    }
+
+    [[nodiscard]] virtual auto go(const SearchSettings &, const timeout_type) -> std::string override {
+        if (illegal_move) {
+            return *illegal_move;
+        }
+        return m_opening.at(m_ply);
+    }
+
+    // The referee knows the rules, so it should never have to ask
+    [[nodiscard]] virtual auto query_p1turn(const timeout_type) -> bool override {
+        throw std::logic_error("Unexpected query");
+    }
+
+    [[nodiscard]] virtual auto query_gameover(const timeout_type) -> bool override {
+        throw std::logic_error("Unexpected query");
+    }
+
+    [[nodiscard]] virtual auto query_result(const timeout_type) -> std::string override {
+        throw std::logic_error("Unexpected query");
+    }
+
+    // Sent instead of a legal move if set
+    std::optional<std::string> illegal_move;
+
+   private:
+    std::vector<std::string> m_opening = {"e2e4", "e7e5", "g1f3", "b8c6"};
+    std::size_t m_ply = 0;
+};
+
+TEST_CASE("Chess - Illegal move") {
+    const std::array movestrs = {
+        // Blocked or empty from the start position and after 1. e4
+        "e2e5",
+        "a1a8",
+        "e1g1",
+        // Not a move at all
+        "0000",
+        "",
+        "e9e4",
+        "nonsense",
+    };
+
+    const auto game_type = GameType::Chess;
+    const auto timecontrol = SearchSettings{};
+    const auto adjudication = AdjudicationSettings{};
+    const auto protocol = ProtocolSettings{};
+    auto engine1 = std::make_shared<TestEngine>();
+    auto engine2 = std::make_shared<TestEngine>();
+
+    for (const auto &movestr : movestrs) {
+        engine1->illegal_move = movestr;
+
+        for (const auto is_engine1_p1 : {true, false}) {
+            const auto &p1 = is_engine1_p1 ? engine1 : engine2;
+            const auto &p2 = is_engine1_p1 ? engine2 : engine1;
+            const auto gg = play_game(game_type, timecontrol, adjudication, protocol, startpos, p1, p2);
+
+            REQUIRE(gg.reason == AdjudicationReason::IllegalMove);
+            REQUIRE(gg.result == (is_engine1_p1 ? GameResult::Player2Win : GameResult::Player1Win));
+            // The illegal move never reached the board
+            REQUIRE(gg.game->move_history().size() == (is_engine1_p1 ? 0 : 1));
+            REQUIRE(gg.game->position().command() ==
+                    (is_engine1_p1 ? std::string("position fen ") + startpos
+                                   : std::string("position fen ") + startpos + " moves e2e4"));
+            REQUIRE(!gg.game->is_gameover(nullptr));
+        }
+    }
+}
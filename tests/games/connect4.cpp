@@ -0,0 +1,431 @@
+#include <doctest/doctest.h>
+#include <array>
+#include <chrono>
+#include <engine/engine.hpp>
+#include <games/connect4.hpp>
+#include <match/play.hpp>
+#include <match/settings.hpp>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include "games/game.hpp"
+
+// Plays the leftmost column with space left
+class TestEngine final : public Engine {
+   public:
+    virtual ~TestEngine() override = default;
+
+    [[nodiscard]] virtual auto is_running() -> bool override {
+        return true;
+    }
+
+    virtual auto init(const timeout_type) -> void override {
+    }
+
+    virtual auto is_ready(const timeout_type timeout) -> void override {
+        if (silent_ready) {
+            // A real engine would wait out the timeout, without one the test would hang
+            REQUIRE(timeout);
+            m_timed_out = true;
+        }
+    }
+
+    virtual auto newgame() -> void override {
+    }
+
+    virtual auto quit() -> void override {
+    }
+
+    virtual auto stop() -> void override {
+    }
+
+    virtual auto position(const GamePosition &position) -> void override {
+        last_command = position.command();
+        m_pos.emplace(position.start_fen());
+        for (const auto movestr : position.moves()) {
+            m_pos->makemove(std::string(movestr));
+        }
+    }
+
+    virtual auto set_option(const std::string &, const std::string &) -> void override {
+    }
+
+    [[nodiscard]] virtual auto go(const SearchSettings &, const timeout_type timeout) -> std::string override {
+        num_go_received++;
+        m_search_time = search_time;
+        if (silent_search) {
+            REQUIRE(timeout);
+            m_timed_out = true;
+            return "0000";
+        }
+        if (illegal_move) {
+            return *illegal_move;
+        }
+        return reply();
+    }
+
+    virtual auto go_ponder(const SearchSettings &) -> void override {
+        num_ponder_received++;
+    }
+
+    // The ponder search was already given the position
+    [[nodiscard]] virtual auto ponderhit(const timeout_type) -> std::string override {
+        num_ponderhit_received++;
+        return reply();
+    }
+
+    virtual auto stop_ponder() -> void override {
+        num_stop_ponder_received++;
+    }
+
+    // The referee knows the rules, so it should never have to ask
+    [[nodiscard]] virtual auto query_p1turn(const timeout_type) -> bool override {
+        throw std::logic_error("Unexpected query");
+    }
+
+    [[nodiscard]] virtual auto query_gameover(const timeout_type) -> bool override {
+        throw std::logic_error("Unexpected query");
+    }
+
+    [[nodiscard]] virtual auto query_result(const timeout_type) -> std::string override {
+        throw std::logic_error("Unexpected query");
+    }
+
+    int num_go_received = 0;
+    int num_ponder_received = 0;
+    int num_ponderhit_received = 0;
+    int num_stop_ponder_received = 0;
+    // Sent instead of a legal move if set
+    std::optional<std::string> illegal_move;
+    // Write moves as the square the piece lands on rather than the column
+    bool square_moves = false;
+    // The last position the engine was sent
+    std::string last_command;
+    // Never answer isready or go, as if the engine had hung
+    bool silent_ready = false;
+    bool silent_search = false;
+    // Reported as the length of every search
+    std::optional<std::chrono::microseconds> search_time;
+
+   private:
+    // Expects the opponent to play the leftmost column as well
+    [[nodiscard]] auto reply() -> std::string {
+        const auto move = m_pos->legal_moves().at(0);
+        auto next = *m_pos;
+        next.makemove(move);
+        m_ponder_move.reset();
+        if (!next.is_gameover(nullptr)) {
+            m_ponder_move = spell(next, next.legal_moves().at(0));
+        }
+        return spell(*m_pos, move);
+    }
+
+    [[nodiscard]] auto spell(const ConnectFourGame &pos, const std::string &move) const -> std::string {
+        for (auto rank = '1'; square_moves && rank <= '6'; ++rank) {
+            if (pos.is_legal_move(move + rank, nullptr)) {
+                return move + rank;
+            }
+        }
+        return move;
+    }
+
+    std::optional<ConnectFourGame> m_pos;
+};
+
+[[nodiscard]] static auto play(const std::string &fen, const std::initializer_list<std::string> moves)
+    -> ConnectFourGame {
+    auto game = ConnectFourGame(fen);
+    for (const auto &move : moves) {
+        REQUIRE(!game.is_gameover(nullptr));
+        REQUIRE(game.is_legal_move(move, nullptr));
+        game.makemove(move);
+    }
+    return game;
+}
+
+TEST_CASE("Connect Four - Wins") {
+    const std::array<std::initializer_list<std::string>, 6> p1_wins = {{
+        // Vertical
+        {"a", "b", "a", "b", "a", "b", "a"},
+        // Horizontal
+        {"a", "a", "b", "b", "c", "c", "d"},
+        {"g", "g", "f", "f", "e", "e", "d"},
+        // Diagonals
+        {"a", "b", "b", "c", "c", "d", "c", "d", "d", "g", "d"},
+        {"g", "f", "f", "e", "e", "d", "e", "d", "d", "a", "d"},
+        // Squares work as well as columns
+        {"a1", "a2", "b1", "b2", "c1", "c2", "d1"},
+    }};
+
+    for (const auto &moves : p1_wins) {
+        const auto game = play("startpos", moves);
+        REQUIRE(game.is_gameover(nullptr));
+        REQUIRE(game.get_result(nullptr) == "p1win");
+        REQUIRE(game.legal_moves().empty());
+        REQUIRE(!game.is_legal_move("e", nullptr));
+    }
+
+    const auto game = play("startpos", {"g", "a", "b", "a", "b", "a", "b", "a"});
+    REQUIRE(game.is_gameover(nullptr));
+    REQUIRE(game.get_result(nullptr) == "p2win");
+}
+
+TEST_CASE("Connect Four - No wrapping between columns") {
+    // Three at the top of column a and one at the bottom of column b are adjacent bits without the empty 7th row
+    const auto game = ConnectFourGame("x6/x6/x6/o6/o6/ox5 o");
+    REQUIRE(!game.is_gameover(nullptr));
+    REQUIRE(game.get_result(nullptr) == "none");
+}
+
+TEST_CASE("Connect Four - Draw") {
+    // Every column filled with pairs, shifted so nothing lines up
+    const auto game = ConnectFourGame("oxoxoxo/oxoxoxo/xoxoxox/xoxoxox/oxoxoxo/oxoxoxo x");
+    REQUIRE(game.is_gameover(nullptr));
+    REQUIRE(game.get_result(nullptr) == "draw");
+    REQUIRE(game.legal_moves().empty());
+}
+
+TEST_CASE("Connect Four - Turn") {
+    auto game = ConnectFourGame("startpos");
+    REQUIRE(game.turn() == Side::Player1);
+    game.makemove("d");
+    REQUIRE(game.turn() == Side::Player2);
+    game.makemove("d");
+    REQUIRE(game.turn() == Side::Player1);
+    game.makemove("c");
+    REQUIRE(game.turn() == Side::Player2);
+
+    auto other = ConnectFourGame("7/7/7/7/7/3x3 o");
+    REQUIRE(other.turn() == Side::Player2);
+    other.makemove("d");
+    REQUIRE(other.turn() == Side::Player1);
+}
+
+TEST_CASE("Connect Four - Legal moves") {
+    const auto game = play("startpos", {"a", "a", "a", "a", "a", "a"});
+    REQUIRE(!game.is_gameover(nullptr));
+    REQUIRE(game.legal_moves() == std::vector<std::string>{"b", "c", "d", "e", "f", "g"});
+    REQUIRE(game.is_p1_turn(nullptr));
+
+    for (const auto move : {"a", "a7", "h", "", "b2", "b0", "bb", "b1 ", "0000", "B"}) {
+        REQUIRE(!game.is_legal_move(move, nullptr));
+    }
+    REQUIRE(game.is_legal_move("b", nullptr));
+    REQUIRE(game.is_legal_move("b1", nullptr));
+
+    auto copy = game;
+    REQUIRE_THROWS_AS(copy.makemove("a"), std::invalid_argument);
+    REQUIRE(copy.move_history().size() == 6);
+}
+
+TEST_CASE("Connect Four - FEN") {
+    REQUIRE(ConnectFourGame("7/7/7/7/7/7 o").get_first_mover() == Side::Player2);
+    REQUIRE(ConnectFourGame("7/7/7/7/7/3x3 o").legal_moves().size() == 7);
+
+    for (const auto fen : {"7/7/7/7/7 x",
+                           "7/7/7/7/7/7/7 x",
+                           "7/7/7/7/7/7",
+                           "7/7/7/7/7/7 y",
+                           "7/7/7/7/7/6 x",
+                           "7/7/7/7/7/8 x",
+                           "7/7/7/7/7/xxxxxxxx x",
+                           "7/7/7/7/x6/7 x",
+                           "7/7/7/7/7/7 x 0 1"}) {
+        REQUIRE_THROWS_AS(static_cast<void>(ConnectFourGame(fen)), std::invalid_argument);
+    }
+}
+
+TEST_CASE("Connect Four - Play games") {
+    const auto game_type = GameType::ConnectFour;
+    const auto timecontrol = SearchSettings{};
+    const auto adjudication = AdjudicationSettings{};
+    const auto protocol = ProtocolSettings{};
+    auto engine1 = std::make_shared<TestEngine>();
+    auto engine2 = std::make_shared<TestEngine>();
+
+    for (const auto is_engine1_p1 : {true, false}) {
+        const auto &p1 = is_engine1_p1 ? engine1 : engine2;
+        const auto &p2 = is_engine1_p1 ? engine2 : engine1;
+        const auto gg = play_game(game_type, timecontrol, adjudication, protocol, "startpos", p1, p2);
+
+        // Both fill columns a to c bottom up, so player 1 completes the bottom row with d
+        REQUIRE(gg.reason == AdjudicationReason::None);
+        REQUIRE(gg.result == GameResult::Player1Win);
+        REQUIRE(gg.game->move_history().size() == 19);
+        REQUIRE(gg.game->move_history().back() == "d");
+    }
+
+    REQUIRE(engine1->num_go_received == engine2->num_go_received);
+}
+
+TEST_CASE("Connect Four - Ponder") {
+    const auto game_type = GameType::ConnectFour;
+    const auto timecontrol = SearchSettings{};
+    const auto adjudication = AdjudicationSettings{};
+    auto protocol = ProtocolSettings{};
+    protocol.ponder = true;
+    auto engine1 = std::make_shared<TestEngine>();
+    auto engine2 = std::make_shared<TestEngine>();
+
+    for (const auto is_engine1_p1 : {true, false}) {
+        const auto &p1 = is_engine1_p1 ? engine1 : engine2;
+        const auto &p2 = is_engine1_p1 ? engine2 : engine1;
+        const auto gg = play_game(game_type, timecontrol, adjudication, protocol, "startpos", p1, p2);
+
+        REQUIRE(gg.reason == AdjudicationReason::None);
+        REQUIRE(gg.result == GameResult::Player1Win);
+        REQUIRE(gg.game->move_history().size() == 19);
+    }
+
+    for (const auto &engine : {engine1, engine2}) {
+        // Only the first move of each game is searched from scratch
+        REQUIRE(engine->num_go_received == 2);
+        REQUIRE(engine->num_ponderhit_received > 0);
+        // Player 2 is left pondering on the winning move, which ends the game instead
+        REQUIRE(engine->num_stop_ponder_received == 1);
+        REQUIRE(engine->num_ponder_received == engine->num_ponderhit_received + engine->num_stop_ponder_received);
+    }
+}
+
+TEST_CASE("Connect Four - Squares") {
+    auto game = ConnectFourGame("startpos");
+    game.makemove("d1");
+    game.makemove("d");
+    game.makemove("d3");
+    REQUIRE(game.move_history() == MoveHistory(MoveEncoding::Text, {"d", "d", "d"}));
+    REQUIRE(game.position().command() == "position startpos moves d d d");
+    REQUIRE(game.canonical_move("d4") == "d");
+    REQUIRE(game.canonical_move("e") == "e");
+    REQUIRE_THROWS_AS(static_cast<void>(game.canonical_move("e2")), std::invalid_argument);
+
+    const auto game_type = GameType::ConnectFour;
+    const auto timecontrol = SearchSettings{};
+    const auto adjudication = AdjudicationSettings{};
+
+    for (const auto ponder : {false, true}) {
+        auto protocol = ProtocolSettings{};
+        protocol.ponder = ponder;
+        auto engine1 = std::make_shared<TestEngine>();
+        auto engine2 = std::make_shared<TestEngine>();
+        engine1->square_moves = true;
+
+        for (const auto is_engine1_p1 : {true, false}) {
+            const auto &p1 = is_engine1_p1 ? engine1 : engine2;
+            const auto &p2 = is_engine1_p1 ? engine2 : engine1;
+            const auto gg = play_game(game_type, timecontrol, adjudication, protocol, "startpos", p1, p2);
+
+            REQUIRE(gg.reason == AdjudicationReason::None);
+            REQUIRE(gg.result == GameResult::Player1Win);
+            REQUIRE(gg.game->move_history().size() == 19);
+            REQUIRE(gg.game->move_history().back() == "d");
+
+            // The opponent is only ever forwarded columns
+            for (const auto move : gg.game->move_history()) {
+                REQUIRE(move.size() == 1);
+            }
+            REQUIRE(engine2->last_command.find_first_of("123456") == std::string::npos);
+        }
+
+        // A ponder move written as a square still counts as a hit
+        REQUIRE(engine1->num_stop_ponder_received == (ponder ? 1 : 0));
+        REQUIRE(engine1->num_go_received == (ponder ? 2 : 19));
+    }
+}
+
+TEST_CASE("Connect Four - Illegal move") {
+    const auto game_type = GameType::ConnectFour;
+    const auto timecontrol = SearchSettings{};
+    const auto adjudication = AdjudicationSettings{};
+    const auto protocol = ProtocolSettings{};
+    auto engine1 = std::make_shared<TestEngine>();
+    auto engine2 = std::make_shared<TestEngine>();
+    engine1->illegal_move = "h";
+
+    for (const auto is_engine1_p1 : {true, false}) {
+        const auto &p1 = is_engine1_p1 ? engine1 : engine2;
+        const auto &p2 = is_engine1_p1 ? engine2 : engine1;
+        const auto gg = play_game(game_type, timecontrol, adjudication, protocol, "startpos", p1, p2);
+
+        REQUIRE(gg.reason == AdjudicationReason::IllegalMove);
+        REQUIRE(gg.result == (is_engine1_p1 ? GameResult::Player2Win : GameResult::Player1Win));
+    }
+}
+
+TEST_CASE("Connect Four - Timeout") {
+    const auto game_type = GameType::ConnectFour;
+    auto adjudication = AdjudicationSettings{};
+    adjudication.timeoutbuffer = 0;
+
+    for (const auto lean : {false, true}) {
+        const auto protocol = ProtocolSettings{.lean = lean};
+
+        for (const auto is_engine1_p1 : {true, false}) {
+            for (const auto &timecontrol : {SearchSettings::as_movetime(10), SearchSettings::as_time(100, 100, 0, 0)}) {
+                auto engine1 = std::make_shared<TestEngine>();
+                auto engine2 = std::make_shared<TestEngine>();
+                engine1->silent_search = true;
+
+                const auto &p1 = is_engine1_p1 ? engine1 : engine2;
+                const auto &p2 = is_engine1_p1 ? engine2 : engine1;
+                const auto gg = play_game(game_type, timecontrol, adjudication, protocol, "startpos", p1, p2);
+
+                REQUIRE(gg.reason == AdjudicationReason::Timeout);
+                REQUIRE(gg.result == (is_engine1_p1 ? GameResult::Player2Win : GameResult::Player1Win));
+                // The move that never arrived isn't played
+                REQUIRE(gg.game->move_history().size() == (is_engine1_p1 ? 0 : 1));
+            }
+        }
+    }
+}
+
+TEST_CASE("Connect Four - Time forfeit") {
+    const auto game_type = GameType::ConnectFour;
+    const auto adjudication = AdjudicationSettings{};
+    const auto protocol = ProtocolSettings{};
+    // The slow engine has time for three moves
+    const auto timecontrol = SearchSettings::as_time(1000, 1000, 0, 0);
+
+    for (const auto is_p1_slow : {true, false}) {
+        auto p1 = std::make_shared<TestEngine>();
+        auto p2 = std::make_shared<TestEngine>();
+        p1->search_time = std::chrono::milliseconds(is_p1_slow ? 300 : 1);
+        p2->search_time = std::chrono::milliseconds(is_p1_slow ? 1 : 300);
+
+        const auto gg = play_game(game_type, timecontrol, adjudication, protocol, "startpos", p1, p2);
+
+        REQUIRE(gg.reason == AdjudicationReason::Timeout);
+        REQUIRE(gg.result == (is_p1_slow ? GameResult::Player2Win : GameResult::Player1Win));
+        // Neither engine stopped responding, so the loser is the side that was to move
+        REQUIRE(!p1->timed_out());
+        REQUIRE(!p2->timed_out());
+        REQUIRE(gg.game->move_history().size() == (is_p1_slow ? 6 : 7));
+        REQUIRE(gg.game->turn() == (is_p1_slow ? Side::Player1 : Side::Player2));
+    }
+}
+
+TEST_CASE("Connect Four - Silent engine") {
+    const auto game_type = GameType::ConnectFour;
+    const auto timecontrol = SearchSettings{};
+    auto adjudication = AdjudicationSettings{};
+    adjudication.replytimeout = 10;
+
+    for (const auto lean : {false, true}) {
+        const auto protocol = ProtocolSettings{.lean = lean};
+
+        for (const auto is_engine1_p1 : {true, false}) {
+            auto engine1 = std::make_shared<TestEngine>();
+            auto engine2 = std::make_shared<TestEngine>();
+            engine1->silent_ready = true;
+
+            const auto &p1 = is_engine1_p1 ? engine1 : engine2;
+            const auto &p2 = is_engine1_p1 ? engine2 : engine1;
+            const auto gg = play_game(game_type, timecontrol, adjudication, protocol, "startpos", p1, p2);
+
+            // Flagged before either side searches, whoever was to move
+            REQUIRE(gg.reason == AdjudicationReason::Timeout);
+            REQUIRE(gg.result == (is_engine1_p1 ? GameResult::Player2Win : GameResult::Player1Win));
+            REQUIRE(engine1->num_go_received == 0);
+            REQUIRE(engine2->num_go_received == 0);
+        }
+    }
+}
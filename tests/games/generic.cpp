@@ -18,10 +18,10 @@ class TestEngine final : public Engine {
         return true;
     }
 
-    virtual auto init() -> void override {
+    virtual auto init(const timeout_type) -> void override {
     }
 
-    virtual auto is_ready() -> void override {
+    virtual auto is_ready(const timeout_type) -> void override {
     }
 
     virtual auto newgame() -> void override {
@@ -34,10 +34,10 @@ class TestEngine final : public Engine {
     virtual auto stop() -> void override {
     }
 
-    virtual auto position(const std::string &start_fen, const std::vector<std::string> &move_history) -> void override {
-        m_pos.set_fen(start_fen);
-        for (const auto &movestr : move_history) {
-            const auto move = libataxx::Move::from_uai(movestr);
+    virtual auto position(const GamePosition &position) -> void override {
+        m_pos.set_fen(position.start_fen());
+        for (const auto movestr : position.moves()) {
+            const auto move = libataxx::Move::from_uai(std::string(movestr));
             m_pos.makemove(move);
         }
     }
@@ -45,7 +45,7 @@ class TestEngine final : public Engine {
     virtual auto set_option(const std::string &, const std::string &) -> void override {
     }
 
-    [[nodiscard]] virtual auto go(const SearchSettings &) -> std::string override {
+    [[nodiscard]] virtual auto go(const SearchSettings &, const timeout_type) -> std::string override {
         num_go_received++;
         const auto moves = m_pos.legal_moves();
         std::stringstream ss;
@@ -53,15 +53,27 @@ class TestEngine final : public Engine {
         return ss.str();
     }
 
-    [[nodiscard]] virtual auto query_p1turn() -> bool override {
+    [[nodiscard]] virtual auto query_p1turn(const timeout_type timeout) -> bool override {
+        if (silent_queries) {
+            no_reply(timeout);
+            return false;
+        }
         return m_pos.get_turn() == libataxx::Side::Black;
     }
 
-    [[nodiscard]] virtual auto query_gameover() -> bool override {
+    [[nodiscard]] virtual auto query_gameover(const timeout_type timeout) -> bool override {
+        if (silent_queries) {
+            no_reply(timeout);
+            return false;
+        }
         return m_pos.is_gameover();
     }
 
-    [[nodiscard]] virtual auto query_result() -> std::string override {
+    [[nodiscard]] virtual auto query_result(const timeout_type timeout) -> std::string override {
+        if (silent_queries) {
+            no_reply(timeout);
+            return "";
+        }
         switch (m_pos.get_result()) {
             case libataxx::Result::BlackWin:
                 return "p1win";
@@ -77,15 +89,23 @@ class TestEngine final : public Engine {
     }
 
     int num_go_received = 0;
+    // Never answer queries, as if the engine had hung
+    bool silent_queries = false;
 
    private:
+    auto no_reply(const timeout_type timeout) -> void {
+        // A real engine would wait out the timeout, without one the test would hang
+        REQUIRE(timeout);
+        m_timed_out = true;
+    }
+
     libataxx::Position m_pos;
 };
 
 [[nodiscard]] static auto get_final(const std::shared_ptr<Game> game) -> libataxx::Position {
     auto pos = libataxx::Position(game->start_fen());
-    for (const auto &movestr : game->move_history()) {
-        const auto move = libataxx::Move::from_uai(movestr);
+    for (const auto movestr : game->move_history()) {
+        const auto move = libataxx::Move::from_uai(std::string(movestr));
 
         REQUIRE(!pos.is_gameover());
         REQUIRE_EQ(pos.get_result(), libataxx::Result::None);
@@ -313,3 +333,25 @@ TEST_CASE("Generic - Draw") {
         }
     }
 }
+
+TEST_CASE("Generic - Silent engine") {
+    const auto game_type = GameType::Generic;
+    const auto timecontrol = SearchSettings{};
+    auto adjudication = AdjudicationSettings{};
+    adjudication.replytimeout = 10;
+    const auto protocol = ProtocolSettings{};
+
+    for (const auto is_engine1_p1 : {true, false}) {
+        auto engine1 = std::make_shared<TestEngine>();
+        auto engine2 = std::make_shared<TestEngine>();
+        engine1->silent_queries = true;
+
+        const auto &p1 = is_engine1_p1 ? engine1 : engine2;
+        const auto &p2 = is_engine1_p1 ? engine2 : engine1;
+        const auto gg = play_game(game_type, timecontrol, adjudication, protocol, "startpos", p1, p2);
+
+        REQUIRE(gg.reason == AdjudicationReason::Timeout);
+        REQUIRE(gg.result == (is_engine1_p1 ? GameResult::Player2Win : GameResult::Player1Win));
+        REQUIRE(engine1->num_go_received == 0);
+    }
+}
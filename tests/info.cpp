@@ -0,0 +1,42 @@
+#include <doctest/doctest.h>
+#include <engine/search_info.hpp>
+
+TEST_CASE("parse_info()") {
+    auto info = SearchInfo();
+
+    REQUIRE(parse_info("info depth 4 seldepth 6 score cp -107 time 12 nodes 473 nps 39416 pv f1 b1 g2 a2", info));
+    REQUIRE(info.depth == 4);
+    REQUIRE(info.seldepth == 6);
+    REQUIRE(info.score == -107);
+    REQUIRE(!info.is_mate);
+    REQUIRE(info.has_score);
+    REQUIRE(info.time == 12);
+    REQUIRE(info.nodes == 473);
+    REQUIRE(info.nps == 39416);
+
+    // Fields not in the line are kept
+    REQUIRE(parse_info("info depth 5 score mate 3 pv depth 9", info));
+    REQUIRE(info.depth == 5);
+    REQUIRE(info.score == 3);
+    REQUIRE(info.is_mate);
+    REQUIRE(info.nodes == 473);
+
+    REQUIRE(parse_info("info string depth 12", info));
+    REQUIRE(info.depth == 5);
+}
+
+TEST_CASE("parse_info() - Not info") {
+    const std::string_view tests[] = {
+        "",
+        " ",
+        "bestmove e2e4",
+        "information depth 3",
+        "readyok",
+    };
+
+    for (const auto &line : tests) {
+        auto info = SearchInfo();
+        REQUIRE(!parse_info(line, info));
+        REQUIRE(info.depth == 0);
+    }
+}
@@ -0,0 +1,62 @@
+#include <doctest/doctest.h>
+#include <chrono>
+#include <cstdint>
+#include <engine/latency.hpp>
+
+using namespace std::chrono_literals;
+
+TEST_CASE("LatencyHistogram - Buckets") {
+    // Small values are exact
+    for (std::uint64_t i = 0; i < 2 * LatencyHistogram::sub_buckets; ++i) {
+        REQUIRE(LatencyHistogram::index(i) == i);
+        REQUIRE(LatencyHistogram::highest_equivalent(i) == i);
+    }
+
+    // Larger ones are within a bucket's width and the buckets don't overlap
+    for (std::uint64_t i = 1; i < 1'000'000; i = i * 3 / 2 + 1) {
+        const auto idx = LatencyHistogram::index(i);
+        REQUIRE(LatencyHistogram::highest_equivalent(idx) >= i);
+        REQUIRE(LatencyHistogram::highest_equivalent(idx) - i <= i / LatencyHistogram::sub_buckets);
+        REQUIRE(LatencyHistogram::index(LatencyHistogram::highest_equivalent(idx) + 1) == idx + 1);
+    }
+
+    REQUIRE(LatencyHistogram::index(UINT64_MAX) < LatencyHistogram::num_buckets);
+}
+
+TEST_CASE("LatencyHistogram - Percentiles") {
+    auto histogram = LatencyHistogram();
+    REQUIRE(histogram.count() == 0);
+    REQUIRE(histogram.percentile(50.0) == 0us);
+
+    for (int i = 1; i <= 100; ++i) {
+        histogram.record(std::chrono::microseconds(i));
+    }
+    histogram.record(10'000us);
+
+    REQUIRE(histogram.count() == 101);
+    REQUIRE(histogram.max() == 10'000us);
+    REQUIRE(histogram.percentile(0.0) == 1us);
+    REQUIRE(histogram.percentile(50.0) >= 51us);
+    REQUIRE(histogram.percentile(50.0) <= 54us);
+    REQUIRE(histogram.percentile(99.0) >= 100us);
+    REQUIRE(histogram.percentile(99.0) <= 103us);
+    REQUIRE(histogram.percentile(100.0) == 10'000us);
+}
+
+TEST_CASE("LatencyHistogram - Merge") {
+    auto a = LatencyHistogram();
+    auto b = LatencyHistogram();
+
+    a.record(5us);
+    a.record(7us);
+    b.record(3us);
+    b.record(2'000us);
+
+    a.merge(b);
+
+    REQUIRE(a.count() == 4);
+    REQUIRE(a.max() == 2'000us);
+    REQUIRE(a.percentile(25.0) == 3us);
+    REQUIRE(a.percentile(50.0) == 5us);
+    REQUIRE(a.percentile(75.0) == 7us);
+}
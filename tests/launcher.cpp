@@ -0,0 +1,50 @@
+#include <doctest/doctest.h>
+#include <unistd.h>
+#include <array>
+#include <chrono>
+#include <engine/launcher.hpp>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+TEST_CASE("launch()") {
+    auto process = launch("echo", "hello  world");
+    REQUIRE(process.pid > 0);
+
+    auto output = std::string();
+    std::array<char, 64> buffer;
+    while (true) {
+        const auto num_read = ::read(process.out, buffer.data(), buffer.size());
+        if (num_read <= 0) {
+            break;
+        }
+        output.append(buffer.data(), static_cast<std::size_t>(num_read));
+    }
+
+    // Arguments are passed through without a shell
+    REQUIRE(output == "hello world\n");
+
+    terminate(process);
+    REQUIRE(process.pid == -1);
+    REQUIRE(!is_running(process));
+}
+
+TEST_CASE("launch() - Missing executable") {
+    REQUIRE_THROWS_AS(static_cast<void>(launch("/path/to/nothing", "")), std::runtime_error);
+}
+
+TEST_CASE("cpu_time()") {
+    auto process = launch("sha256sum", "/dev/zero");
+
+    const auto t0 = cpu_time(process);
+    REQUIRE(t0);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    const auto t1 = cpu_time(process);
+    REQUIRE(t1);
+    REQUIRE(*t1 > *t0);
+
+    terminate(process);
+    REQUIRE(!cpu_time(process));
+}
@@ -0,0 +1,164 @@
+#include <doctest/doctest.h>
+#include <pthread.h>
+#include <signal.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <engine/line_reader.hpp>
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace {
+
+constexpr auto timeout = std::chrono::seconds(5);
+
+std::atomic<bool> interrupted = false;
+
+class [[nodiscard]] Pipe {
+   public:
+    [[nodiscard]] Pipe() {
+        REQUIRE(::pipe(m_fds) == 0);
+    }
+
+    Pipe(const Pipe &) = delete;
+
+    auto operator=(const Pipe &) -> Pipe & = delete;
+
+    ~Pipe() {
+        close_write();
+        ::close(m_fds[0]);
+    }
+
+    [[nodiscard]] auto read_end() const noexcept -> int {
+        return m_fds[0];
+    }
+
+    auto write(const std::string_view data) -> void {
+        REQUIRE(::write(m_fds[1], data.data(), data.size()) == static_cast<ssize_t>(data.size()));
+    }
+
+    auto close_write() noexcept -> void {
+        if (m_fds[1] >= 0) {
+            ::close(m_fds[1]);
+            m_fds[1] = -1;
+        }
+    }
+
+   private:
+    int m_fds[2] = {-1, -1};
+};
+
+[[nodiscard]] auto deadline() -> LineReader::clock_type::time_point {
+    return LineReader::clock_type::now() + timeout;
+}
+
+}  // namespace
+
+TEST_CASE("LineReader - Lines") {
+    auto pipe = Pipe();
+    auto reader = LineReader(pipe.read_end());
+    auto line = std::string();
+
+    pipe.write("id name test\r\nreadyok\n\nbestmove a1\n");
+
+    REQUIRE(reader.read_line(line, deadline()) == LineReader::Status::Line);
+    REQUIRE(line == "id name test");
+    REQUIRE(reader.read_line(line, deadline()) == LineReader::Status::Line);
+    REQUIRE(line == "readyok");
+    REQUIRE(reader.read_line(line, deadline()) == LineReader::Status::Line);
+    REQUIRE(line.empty());
+    // Buffered lines are returned even once the deadline has passed
+    REQUIRE(reader.read_line(line, LineReader::clock_type::now()) == LineReader::Status::Line);
+    REQUIRE(line == "bestmove a1");
+}
+
+TEST_CASE("LineReader - Partial line at the deadline") {
+    auto pipe = Pipe();
+    auto reader = LineReader(pipe.read_end());
+    auto line = std::string("unchanged");
+
+    pipe.write("bestmove");
+
+    const auto t0 = LineReader::clock_type::now();
+    REQUIRE(reader.read_line(line, t0 + std::chrono::milliseconds(20)) == LineReader::Status::Timeout);
+    REQUIRE(LineReader::clock_type::now() - t0 >= std::chrono::milliseconds(20));
+    REQUIRE(line == "unchanged");
+
+    // The first half is kept for when the rest arrives
+    pipe.write(" a1 ponder b2\nreadyok\n");
+    REQUIRE(reader.read_line(line, deadline()) == LineReader::Status::Line);
+    REQUIRE(line == "bestmove a1 ponder b2");
+    REQUIRE(reader.read_line(line, deadline()) == LineReader::Status::Line);
+    REQUIRE(line == "readyok");
+
+    // Nothing at all
+    REQUIRE(reader.read_line(line, LineReader::clock_type::now()) == LineReader::Status::Timeout);
+}
+
+TEST_CASE("LineReader - EOF") {
+    auto pipe = Pipe();
+    auto reader = LineReader(pipe.read_end());
+    auto line = std::string();
+
+    pipe.write("readyok\nbestm");
+    pipe.close_write();
+
+    REQUIRE(reader.read_line(line, deadline()) == LineReader::Status::Line);
+    REQUIRE(line == "readyok");
+
+    // The unfinished line is dropped, with or without a deadline
+    REQUIRE(reader.read_line(line, deadline()) == LineReader::Status::Closed);
+    REQUIRE(line == "readyok");
+    REQUIRE(reader.read_line(line, {}) == LineReader::Status::Closed);
+}
+
+TEST_CASE("LineReader - EINTR") {
+    // Without SA_RESTART the signal interrupts the poll
+    struct sigaction action = {};
+    struct sigaction previous = {};
+    action.sa_handler = [](int) {
+        interrupted = true;
+    };
+    REQUIRE(::sigaction(SIGUSR1, &action, &previous) == 0);
+
+    auto pipe = Pipe();
+    auto reader = LineReader(pipe.read_end());
+    auto line = std::string();
+    const auto reader_thread = ::pthread_self();
+
+    interrupted = false;
+    auto writer = std::thread([&pipe, reader_thread] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        ::pthread_kill(reader_thread, SIGUSR1);
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        pipe.write("readyok\n");
+    });
+
+    const auto status = reader.read_line(line, deadline());
+    writer.join();
+    ::sigaction(SIGUSR1, &previous, nullptr);
+
+    REQUIRE(interrupted);
+    REQUIRE(status == LineReader::Status::Line);
+    REQUIRE(line == "readyok");
+
+    // An interrupted wait still ends at the deadline
+    interrupted = false;
+    REQUIRE(::sigaction(SIGUSR1, &action, nullptr) == 0);
+    writer = std::thread([reader_thread] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        ::pthread_kill(reader_thread, SIGUSR1);
+    });
+
+    const auto t0 = LineReader::clock_type::now();
+    const auto timed_out = reader.read_line(line, t0 + std::chrono::milliseconds(50));
+    const auto t1 = LineReader::clock_type::now();
+    writer.join();
+    ::sigaction(SIGUSR1, &previous, nullptr);
+
+    REQUIRE(interrupted);
+    REQUIRE(timed_out == LineReader::Status::Timeout);
+    REQUIRE(t1 - t0 >= std::chrono::milliseconds(50));
+    REQUIRE(t1 - t0 < timeout);
+}
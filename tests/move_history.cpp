@@ -0,0 +1,120 @@
+#include <doctest/doctest.h>
+#include <games/move_history.hpp>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+[[nodiscard]] static auto unpack(const MoveHistory &history) -> std::vector<std::string> {
+    auto moves = std::vector<std::string>();
+    for (const auto move : history) {
+        moves.emplace_back(move);
+    }
+    return moves;
+}
+
+TEST_CASE("MoveHistory - Round trip") {
+    const auto check = [](const MoveEncoding encoding, const std::vector<std::string> &moves) {
+        auto history = MoveHistory(encoding);
+        for (const auto &move : moves) {
+            history.push_back(move);
+        }
+        REQUIRE(history.size() == moves.size());
+        REQUIRE(unpack(history) == moves);
+        REQUIRE(history.back() == moves.back());
+        REQUIRE(std::distance(history.begin(), history.end()) == static_cast<std::ptrdiff_t>(moves.size()));
+    };
+
+    check(MoveEncoding::Text, {"1", "", "some long move", "0000", std::string(MoveHistory::max_text_length, 'x')});
+    check(MoveEncoding::Ataxx, {"a1", "g7", "a1c3", "g7e5", "0000", "b2", "c3a1"});
+    check(MoveEncoding::Chess, {"e2e4", "e7e5", "e1g1", "a7a8q", "h2h1n", "b7c8r", "d2d1b", "0000", "h8a1"});
+}
+
+TEST_CASE("MoveHistory - Last move") {
+    auto history = MoveHistory(MoveEncoding::Chess, {"a7a8q"});
+    REQUIRE(history.back() == "a7a8q");
+
+    // Nothing is left over from the longer move before it
+    history.clear();
+    history.push_back("e2e4");
+    REQUIRE(history.back() == "e2e4");
+    REQUIRE(history == MoveHistory(MoveEncoding::Chess, {"e2e4"}));
+}
+
+TEST_CASE("MoveHistory - Canonical form") {
+    auto history = MoveHistory(MoveEncoding::Chess, {"E2E4", "a7a8Q"});
+    REQUIRE(unpack(history) == std::vector<std::string>{"e2e4", "a7a8q"});
+}
+
+TEST_CASE("MoveHistory - Unencodable moves") {
+    for (const auto move : {"", "e2", "e2e", "e2e4qq", "e2e9", "i2e4", "e2e4k", "e2e4 "}) {
+        auto history = MoveHistory(MoveEncoding::Chess);
+        REQUIRE_THROWS_AS(history.push_back(move), std::invalid_argument);
+        REQUIRE(history.empty());
+    }
+
+    for (const auto move : {"", "a", "a1a1", "a1c", "a0", "a1c3x"}) {
+        auto history = MoveHistory(MoveEncoding::Ataxx);
+        REQUIRE_THROWS_AS(history.push_back(move), std::invalid_argument);
+        REQUIRE(history.empty());
+    }
+
+    auto history = MoveHistory();
+    REQUIRE_THROWS_AS(history.push_back(std::string(MoveHistory::max_text_length + 1, 'x')), std::invalid_argument);
+    REQUIRE(history.empty());
+}
+
+TEST_CASE("MoveHistory - Prefixes") {
+    const auto a = MoveHistory(MoveEncoding::Chess, {"e2e4", "e7e5"});
+    const auto b = MoveHistory(MoveEncoding::Chess, {"e2e4", "e7e5", "g1f3"});
+    const auto c = MoveHistory(MoveEncoding::Chess, {"e2e4", "e7e6", "g1f3"});
+
+    REQUIRE(a.starts_with(MoveHistory(MoveEncoding::Chess)));
+    REQUIRE(a.starts_with(a));
+    REQUIRE(b.starts_with(a));
+    REQUIRE(!a.starts_with(b));
+    REQUIRE(!c.starts_with(a));
+    REQUIRE(a != b);
+    REQUIRE(a == MoveHistory(MoveEncoding::Chess, {"e2e4", "e7e5"}));
+
+    // Moves after the prefix, the way a position delta is built
+    auto it = std::next(b.begin(), a.size());
+    REQUIRE(*it == "g1f3");
+    REQUIRE(++it == b.end());
+}
+
+TEST_CASE("MoveHistory - Iterator invalidation") {
+    for (const auto encoding : {MoveEncoding::Text, MoveEncoding::Chess}) {
+        auto history = MoveHistory(encoding, {"e2e4", "e7e5"});
+
+        // Each iterator decodes into its own buffer, so moves read from different ones can be held at once
+        auto first = history.begin();
+        auto second = std::next(first);
+        const auto a = *first;
+        const auto b = *second;
+        REQUIRE(a == "e2e4");
+        REQUIRE(b == "e7e5");
+
+        // Including copies, which are separate iterators
+        auto copy = first;
+        REQUIRE(*++copy == "e7e5");
+        REQUIRE(a == "e2e4");
+
+        // Only copies of the moves survive the buffer growing
+        const auto kept = std::string(*second);
+        const auto last = std::string(history.back());
+        for (int i = 0; i < 100; ++i) {
+            history.push_back("g1f3");
+        }
+        REQUIRE(kept == "e7e5");
+        REQUIRE(last == "e7e5");
+
+        // Iterators taken afterwards see the new buffer
+        REQUIRE(*std::next(history.begin()) == "e7e5");
+        REQUIRE(*std::next(history.begin(), 101) == "g1f3");
+        REQUIRE(std::distance(history.begin(), history.end()) == 102);
+
+        history.clear();
+        REQUIRE(history.begin() == history.end());
+    }
+}
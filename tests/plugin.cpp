@@ -0,0 +1,40 @@
+#include <doctest/doctest.h>
+#include <engine/engine_plugin.hpp>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+TEST_CASE("PluginEngine") {
+    auto engine = PluginEngine(0, TEST_PLUGIN_PATH);
+    auto position = GamePosition();
+    const auto &moves = position.moves();
+
+    engine.init({});
+    engine.set_option("depth", "3");
+    engine.is_ready({});
+    engine.newgame();
+
+    while (true) {
+        engine.position(position);
+        if (engine.query_gameover({})) {
+            break;
+        }
+        REQUIRE(engine.query_p1turn({}) == (moves.size() % 2 == 0));
+        position.push_back(engine.go(SearchSettings::as_nodes(1), {}));
+        REQUIRE(!engine.timed_out());
+        REQUIRE(engine.search_info().depth == 3);
+        REQUIRE(!engine.search_info().has_score);
+    }
+
+    REQUIRE(moves == MoveHistory(MoveEncoding::Text, {"1", "2", "3", "4"}));
+    REQUIRE(engine.query_result({}) == "draw");
+
+    REQUIRE(engine.go(SearchSettings::as_depth(2), {}) == "5");
+    REQUIRE(engine.search_info().depth == 2);
+    REQUIRE(engine.search_info().has_score);
+    REQUIRE(engine.search_info().score == 0);
+}
+
+TEST_CASE("PluginEngine - Missing library") {
+    REQUIRE_THROWS_AS(static_cast<void>(PluginEngine(0, "/path/to/nothing.so")), std::runtime_error);
+}
@@ -0,0 +1,71 @@
+#include <engine/cutegames_plugin.h>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+// A game where the players take turns counting up to four, the move is the next number
+
+namespace {
+
+struct TestEngine {
+    std::size_t ply = 0;
+    int depth = 0;
+};
+
+auto write(const std::string &str, char *buffer, const std::size_t size) -> int {
+    if (str.size() + 1 > size) {
+        return 1;
+    }
+    std::memcpy(buffer, str.c_str(), str.size() + 1);
+    return 0;
+}
+
+const cg_plugin_v2 plugin = {
+    .version = CUTEGAMES_PLUGIN_VERSION,
+    .create = []() -> void * {
+        return new TestEngine();
+    },
+    .destroy =
+        [](void *engine) {
+            delete static_cast<TestEngine *>(engine);
+        },
+    .set_option =
+        [](void *engine, const char *name, const char *value) {
+            if (std::strcmp(name, "depth") == 0) {
+                static_cast<TestEngine *>(engine)->depth = std::atoi(value);
+            }
+        },
+    .newgame =
+        [](void *engine) {
+            static_cast<TestEngine *>(engine)->ply = 0;
+        },
+    .position =
+        [](void *engine, const char *, const char *const *, const std::size_t num_moves) {
+            static_cast<TestEngine *>(engine)->ply = num_moves;
+        },
+    .go = [](void *engine, const cg_search *search, cg_info *info, char *move, const std::size_t size) -> int {
+        const auto e = static_cast<TestEngine *>(engine);
+        info->depth = search->type == CG_SEARCH_DEPTH ? search->depth : e->depth;
+        info->nodes = 1;
+        // Only depth searches get far enough to score the position, and counting up always draws
+        info->has_score = search->type == CG_SEARCH_DEPTH;
+        return write(std::to_string(e->ply + 1), move, size);
+    },
+    .query = [](void *engine, const char *question, char *answer, const std::size_t size) -> int {
+        const auto e = static_cast<TestEngine *>(engine);
+        if (std::strcmp(question, "p1turn") == 0) {
+            return write(e->ply % 2 == 0 ? "true" : "false", answer, size);
+        } else if (std::strcmp(question, "gameover") == 0) {
+            return write(e->ply >= 4 ? "true" : "false", answer, size);
+        } else if (std::strcmp(question, "result") == 0) {
+            return write(e->ply >= 4 ? "draw" : "none", answer, size);
+        }
+        return 1;
+    },
+};
+
+}  // namespace
+
+extern "C" auto cutegames_plugin_v2() -> const cg_plugin_v2 * {
+    return &plugin;
+}
@@ -0,0 +1,83 @@
+#include <doctest/doctest.h>
+#include <chrono>
+#include <engine/shm_transport.hpp>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+namespace {
+
+constexpr auto timeout = std::chrono::seconds(5);
+
+[[nodiscard]] auto deadline() -> ShmTransport::clock_type::time_point {
+    return ShmTransport::clock_type::now() + timeout;
+}
+
+}  // namespace
+
+TEST_CASE("ShmTransport - Both directions") {
+    auto host = ShmTransport::create();
+    auto engine = ShmTransport::open(host->name(), ShmTransport::Role::Engine);
+
+    REQUIRE(host->write("isready\nposition startpos\r\n", deadline()) == 27);
+
+    auto line = std::string();
+    REQUIRE(engine->read_line(line, deadline()) == ShmTransport::Status::Line);
+    REQUIRE(line == "isready");
+    REQUIRE(engine->read_line(line, deadline()) == ShmTransport::Status::Line);
+    REQUIRE(line == "position startpos");
+
+    REQUIRE(engine->write("readyok\n", deadline()) == 8);
+    REQUIRE(host->read_line(line, deadline()) == ShmTransport::Status::Line);
+    REQUIRE(line == "readyok");
+}
+
+TEST_CASE("ShmTransport - Timeout") {
+    auto host = ShmTransport::create();
+    auto engine = ShmTransport::open(host->name(), ShmTransport::Role::Engine);
+
+    // Partial lines aren't returned
+    REQUIRE(engine->write("bestmove", deadline()) == 8);
+
+    auto line = std::string();
+    const auto t0 = ShmTransport::clock_type::now();
+    REQUIRE(host->read_line(line, t0 + std::chrono::milliseconds(20)) == ShmTransport::Status::Timeout);
+    REQUIRE(ShmTransport::clock_type::now() - t0 >= std::chrono::milliseconds(20));
+
+    REQUIRE(engine->write(" a1\n", deadline()) == 4);
+    REQUIRE(host->read_line(line, deadline()) == ShmTransport::Status::Line);
+    REQUIRE(line == "bestmove a1");
+
+    // Nobody is reading, so a full ring stops the write at the deadline
+    const auto big = std::string(ShmRing::capacity + 100, 'x');
+    REQUIRE(host->write(big, ShmTransport::clock_type::now() + std::chrono::milliseconds(20)) == ShmRing::capacity);
+}
+
+TEST_CASE("ShmTransport - Wrap around") {
+    auto host = ShmTransport::create();
+    auto engine = ShmTransport::open(host->name(), ShmTransport::Role::Engine);
+
+    // Send a lot more than fits in the ring while the other thread sleeps and wakes
+    constexpr auto num_lines = 20'000;
+    auto reader = std::thread([&engine]() {
+        auto line = std::string();
+        for (auto i = 0; i < num_lines; ++i) {
+            REQUIRE(engine->read_line(line, deadline()) == ShmTransport::Status::Line);
+            REQUIRE(line == "info depth " + std::to_string(i));
+        }
+    });
+
+    for (auto i = 0; i < num_lines; ++i) {
+        const auto msg = "info depth " + std::to_string(i) + "\n";
+        REQUIRE(host->write(msg, deadline()) == msg.size());
+    }
+
+    reader.join();
+}
+
+TEST_CASE("ShmTransport - Unlink") {
+    auto host = ShmTransport::create();
+    host->unlink();
+    REQUIRE_THROWS_AS(static_cast<void>(ShmTransport::open(host->name(), ShmTransport::Role::Engine)),
+                      std::runtime_error);
+}
@@ -0,0 +1,51 @@
+#include <doctest/doctest.h>
+#include <chrono>
+#include <spawner.hpp>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+
+template <typename T>
+auto wait_for_size(const Spawner<T> &spawner, const std::size_t id, const std::size_t size) -> bool {
+    for (int i = 0; i < 1000; ++i) {
+        if (spawner.size(id) == size) {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return false;
+}
+
+}  // namespace
+
+TEST_CASE("Spawner::get()") {
+    auto spawner = Spawner<std::size_t>(2, 2, 1, [](const std::size_t id) {
+        return std::make_shared<std::size_t>(id);
+    });
+
+    REQUIRE(wait_for_size(spawner, 0, 2));
+    REQUIRE(wait_for_size(spawner, 1, 2));
+
+    const auto a = spawner.get(1);
+    REQUIRE(a);
+    REQUIRE(**a == 1);
+
+    // Replaced in the background
+    REQUIRE(wait_for_size(spawner, 1, 2));
+
+    REQUIRE(!spawner.get(2));
+}
+
+TEST_CASE("Spawner - Factory failure") {
+    auto spawner = Spawner<int>(2, 1, 1, [](const std::size_t id) -> std::shared_ptr<int> {
+        if (id == 0) {
+            throw std::runtime_error("Can't create");
+        }
+        return std::make_shared<int>(1);
+    });
+
+    REQUIRE(wait_for_size(spawner, 1, 1));
+    REQUIRE(!spawner.get(0));
+    REQUIRE(spawner.get(1));
+}
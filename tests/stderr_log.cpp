@@ -0,0 +1,143 @@
+#include <doctest/doctest.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <engine/launcher.hpp>
+#include <engine/stderr_log.hpp>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace {
+
+[[nodiscard]] auto read_file(const std::string &path) -> std::string {
+    auto file = std::ifstream(path);
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+// The log is written in the background, so give it a moment
+[[nodiscard]] auto wait_for_text(const std::string &path, const std::string &text) -> bool {
+    for (int i = 0; i < 200; ++i) {
+        if (read_file(path).find(text) != std::string::npos) {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return false;
+}
+
+}  // namespace
+
+TEST_CASE("StderrLog") {
+    const auto directory = std::filesystem::temp_directory_path() / ("cutegames-" + std::to_string(::getpid()));
+    std::filesystem::remove_all(directory);
+
+    SUBCASE("Capture") {
+        auto log = StderrLog(directory.string(), {"Engine 1", "Engine 2"}, 0, 0);
+        REQUIRE(log.path(0) == (directory / "Engine_1.log").string());
+        REQUIRE(log.path(1) == (directory / "Engine_2.log").string());
+
+        auto process = launch("ls", "/path/to/nothing", true);
+        REQUIRE(process.err != -1);
+        REQUIRE((::fcntl(process.err, F_GETFL) & O_NONBLOCK) != 0);
+        log.attach(process.err, 1, process.pid);
+
+        REQUIRE(wait_for_text(log.path(1), "[" + std::to_string(process.pid) + "] "));
+        REQUIRE(wait_for_text(log.path(1), "/path/to/nothing"));
+        REQUIRE(read_file(log.path(0)).empty());
+
+        log.detach(process.err);
+        terminate(process);
+        REQUIRE(process.err == -1);
+    }
+
+    SUBCASE("Rotation") {
+        constexpr auto max_bytes = 200;
+        auto log = StderrLog(directory.string(), {"engine"}, max_bytes, 2);
+
+        auto parameters = std::string();
+        for (int i = 0; i < 50; ++i) {
+            parameters += " /path/to/nothing" + std::to_string(i);
+        }
+
+        auto process = launch("ls", parameters, true);
+        log.attach(process.err, 0, process.pid);
+
+        REQUIRE(wait_for_text(log.path(0), "/path/to/nothing49"));
+
+        log.detach(process.err);
+        terminate(process);
+
+        // Only the newest lines are kept, and no file grows past the limit
+        REQUIRE(std::filesystem::exists(log.path(0) + ".1"));
+        REQUIRE(std::filesystem::exists(log.path(0) + ".2"));
+        REQUIRE(!std::filesystem::exists(log.path(0) + ".3"));
+        REQUIRE(std::filesystem::file_size(log.path(0)) <= max_bytes);
+        REQUIRE(std::filesystem::file_size(log.path(0) + ".1") <= max_bytes);
+        REQUIRE(std::filesystem::file_size(log.path(0) + ".2") <= max_bytes);
+        REQUIRE(read_file(log.path(0) + ".2").find("/path/to/nothing0") == std::string::npos);
+    }
+
+    SUBCASE("Detach from an engine that never stops writing") {
+        // Rotated so that reading the log back stays quick
+        auto log = StderrLog(directory.string(), {"engine"}, 4096, 1);
+
+        int fds[2];
+        REQUIRE(::pipe(fds) == 0);
+        REQUIRE(::fcntl(fds[0], F_SETFL, O_NONBLOCK) == 0);
+        // Never blocks, so the writer notices when it's told to stop
+        REQUIRE(::fcntl(fds[1], F_SETFL, O_NONBLOCK) == 0);
+
+        auto stop = std::atomic<bool>(false);
+        auto writer = std::thread([&stop, fd = fds[1]] {
+            const auto line = std::string_view("spam\n");
+            while (!stop) {
+                static_cast<void>(::write(fd, line.data(), line.size()));
+            }
+        });
+
+        log.attach(fds[0], 0, 0);
+        REQUIRE(wait_for_text(log.path(0), "spam"));
+        log.detach(fds[0]);
+
+        stop = true;
+        writer.join();
+        ::close(fds[0]);
+        ::close(fds[1]);
+    }
+
+    SUBCASE("Reused fd") {
+        auto log = StderrLog(directory.string(), {"engine"}, 0, 0);
+
+        int first[2];
+        REQUIRE(::pipe2(first, O_NONBLOCK) == 0);
+        log.attach(first[0], 0, 1);
+        REQUIRE(::write(first[1], "first\n", 6) == 6);
+        REQUIRE(wait_for_text(log.path(0), "[1] first"));
+        log.detach(first[0]);
+        ::close(first[1]);
+
+        // A new pipe that ends up with the same fd as the old one
+        int second[2];
+        REQUIRE(::pipe2(second, O_NONBLOCK) == 0);
+        REQUIRE(::dup2(second[0], first[0]) == first[0]);
+        ::close(second[0]);
+        log.attach(first[0], 0, 2);
+
+        // Nothing to read doesn't block anything
+        log.detach(first[0]);
+        log.attach(first[0], 0, 3);
+
+        REQUIRE(::write(second[1], "second\n", 7) == 7);
+        REQUIRE(wait_for_text(log.path(0), "[3] second"));
+        log.detach(first[0]);
+        ::close(first[0]);
+        ::close(second[1]);
+    }
+
+    std::filesystem::remove_all(directory);
+}
@@ -0,0 +1,40 @@
+#include <doctest/doctest.h>
+#include <chrono>
+#include <engine/launcher.hpp>
+#include <engine/watchdog.hpp>
+#include <thread>
+
+using namespace std::chrono_literals;
+
+TEST_CASE("Watchdog - Kill after the deadline") {
+    auto watchdog = Watchdog(0ms, 0ms);
+    auto process = launch("sleep", "10");
+
+    const auto ticket = watchdog.arm(process.pid, Watchdog::clock_type::now() + 20ms);
+
+    // Give it plenty of time to fire, then make sure it did
+    for (int i = 0; i < 200 && is_running(process); ++i) {
+        std::this_thread::sleep_for(10ms);
+    }
+
+    REQUIRE(!is_running(process));
+    REQUIRE(watchdog.disarm(ticket));
+    terminate(process);
+}
+
+TEST_CASE("Watchdog - Disarm before the deadline") {
+    auto watchdog = Watchdog(0ms, 0ms);
+    auto process = launch("sleep", "10");
+
+    const auto ticket1 = watchdog.arm(process.pid, Watchdog::clock_type::now() + 50ms);
+    const auto ticket2 = watchdog.arm(process.pid, Watchdog::clock_type::now() + 60ms);
+    REQUIRE(ticket1 != ticket2);
+
+    REQUIRE(!watchdog.disarm(ticket1));
+    REQUIRE(!watchdog.disarm(ticket2));
+    REQUIRE(!watchdog.disarm(ticket2));
+
+    std::this_thread::sleep_for(100ms);
+    REQUIRE(is_running(process));
+    terminate(process);
+}